@@ -0,0 +1,244 @@
+#include "phoenix/common/logger.hpp"
+#include "phoenix/graph/router.hpp"
+#include "phoenix/tags.hpp"
+
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <immintrin.h>
+
+// Producer side cost of PHOENIX_LOG_INFO against the previous stringstream + spsc_queue<Entry> logger
+
+using namespace phoenix;
+
+namespace {
+
+struct Traits
+{};
+
+struct Config
+{
+    std::string logFolder = ".";
+    std::string instrument = "bench";
+    LogLevel logLevel = LogLevel::INFO;
+    bool printLogs = false;
+    LogOverflow logOverflow = LogOverflow::SPILL;
+    LogIdle logIdle = LogIdle::BACKOFF;
+    int logCpu = -1;
+};
+
+template<typename NodeBase>
+struct Risk : NodeBase
+{
+    using NodeBase::NodeBase;
+
+    void handle(tag::Risk::Abort) { std::abort(); }
+};
+
+// clang-format off
+using Graph = Router<
+    Config,
+    Traits,
+    NodeList<
+        Logger,
+        Risk
+    >
+>;
+// clang-format on
+
+// the logger as it was before deferred formatting
+struct LegacyLogger
+{
+    struct Entry
+    {
+        int line;
+        LogLevel level;
+        std::string message;
+        std::string filename;
+    };
+
+    LegacyLogger()
+        : consumer{[this]
+                   {
+                       Entry entry;
+                       while (running.test())
+                           while (entries.pop(entry))
+                               ;
+                   }}
+    {}
+
+    ~LegacyLogger()
+    {
+        running.clear();
+        consumer.join();
+    }
+
+    template<typename... Args>
+    void log(LogLevel level, std::string_view filename, int line, Args&&... args)
+    {
+        cache.str("");
+        cache.clear();
+        ((cache << " " << args), ...);
+
+        Entry entry{.line = line, .level = level, .message = cache.str(), .filename = std::string{filename}};
+        while (!entries.push(entry))
+            _mm_pause();
+    }
+
+    std::atomic_flag running = true;
+    boost::lockfree::spsc_queue<Entry> entries{8192u};
+    std::stringstream cache;
+    std::thread consumer;
+};
+
+constexpr std::size_t BURST = 64u;
+constexpr std::size_t BURSTS = 2000u;
+
+template<typename Func>
+void run(std::string_view name, Func&& logBurst)
+{
+    std::vector<double> perCall;
+    perCall.reserve(BURSTS);
+
+    for (std::size_t i = 0u; i < BURSTS; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        logBurst(i);
+        auto end = std::chrono::steady_clock::now();
+
+        perCall.push_back(std::chrono::duration<double, std::nano>(end - start).count() / (2u * BURST));
+
+        // let the consumer catch up so only the producer is measured
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    std::sort(perCall.begin(), perCall.end());
+    double mean = 0.0;
+    for (double value : perCall)
+        mean += value;
+    mean /= perCall.size();
+
+    std::cout << name << ": mean " << mean << " ns, p50 " << perCall[perCall.size() / 2u] << " ns, p99 "
+              << perCall[perCall.size() * 99u / 100u] << " ns per call" << std::endl;
+}
+
+// sustained rate of the formatting side, the single threaded logger formats every entry on push
+constexpr std::size_t SUSTAINED_ENTRIES = 1'000'000u;
+
+template<typename Func>
+void runSustained(std::string_view name, Func&& logOne)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0u; i < SUSTAINED_ENTRIES; ++i)
+        logOne(i);
+    auto end = std::chrono::steady_clock::now();
+
+    double const seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << name << ": " << static_cast<std::uint64_t>(SUSTAINED_ENTRIES / seconds) << " entries/s" << std::endl;
+}
+
+// the sink as it was before, gmtime + put_time per entry and a flush per line
+struct LegacySink
+{
+    explicit LegacySink(std::string const& path)
+        : file{path, std::ios::app}
+    {}
+
+    template<typename... Args>
+    void log(LogLevel level, std::string_view filename, int line, Args&&... args)
+    {
+        cache.str("");
+        cache.clear();
+
+        auto const timeT = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        cache << std::put_time(std::gmtime(&timeT), "%Y-%m-%dT%H:%M:%SZ") << " [" << logLevelString(level) << "] "
+              << filename << ":" << line << " -";
+        ((cache << " " << args), ...);
+
+        file << cache.str() << std::endl;
+    }
+
+    std::ofstream file;
+    std::stringstream cache;
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Config config;
+    if (argc > 1)
+        config.logFolder = argv[1];
+
+    std::string const orderId{"ETH-1234567890"};
+
+    {
+        Graph graph{config};
+        auto* handler = graph.getHandler();
+        handler->invoke(tag::Logger::Start{});
+
+        run("PHOENIX_LOG_INFO",
+            [&](std::size_t i)
+            {
+                for (std::size_t j = 0u; j < BURST; ++j)
+                {
+                    double const price = 1.0 + j * 0.0001;
+                    PHOENIX_LOG_INFO(handler, "[OPP CASE 1]", price, '*', 0.9998, '>', 65000.5 + i);
+                    PHOENIX_LOG_INFO(handler, "[NEW ORDER]", std::string_view{orderId}, "BUY", 0.5, '@', price);
+                }
+            });
+
+        handler->invoke(tag::Logger::Stop{});
+    }
+
+    {
+        LegacyLogger legacy;
+        run("stringstream + spsc_queue<Entry>",
+            [&](std::size_t i)
+            {
+                for (std::size_t j = 0u; j < BURST; ++j)
+                {
+                    double const price = 1.0 + j * 0.0001;
+                    legacy.log(LogLevel::INFO, "hitter.hpp", __LINE__, "[OPP CASE 1]", price, '*', 0.9998, '>', 65000.5 + i);
+                    legacy.log(LogLevel::INFO, "hitter.hpp", __LINE__, "[NEW ORDER]", std::string_view{orderId}, "BUY", 0.5, '@', price);
+                }
+            });
+    }
+
+    {
+        Graph graph{config};
+        auto* handler = graph.getHandler();
+        handler->invoke(tag::Logger::Start{}, false, true);
+
+        runSustained("LogSink",
+                     [&](std::size_t i)
+                     {
+                         double const price = 1.0 + i * 0.0001;
+                         PHOENIX_LOG_INFO(handler, "[NEW ORDER]", std::string_view{orderId}, "BUY", 0.5, '@', price);
+                     });
+
+        handler->invoke(tag::Logger::Stop{});
+    }
+
+    {
+        LegacySink legacy{config.logFolder + "/bench-legacy.log"};
+        runSustained("ofstream + put_time + endl",
+                     [&](std::size_t i)
+                     {
+                         double const price = 1.0 + i * 0.0001;
+                         legacy.log(LogLevel::INFO, "hitter.hpp", __LINE__, "[NEW ORDER]", std::string_view{orderId}, "BUY", 0.5, '@', price);
+                     });
+    }
+}
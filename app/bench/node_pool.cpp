@@ -0,0 +1,246 @@
+#include "phoenix/data/decimal.hpp"
+#include "phoenix/data/order_book.hpp"
+#include "phoenix/tools/node_arena.hpp"
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+// Allocation cost of the book maps under insert/erase churn
+// std::allocator, the previous scanning NodePool singleton, and NodeArena with and without huge pages
+// usage: phoenix_bench_node_pool [operations] [resting levels]
+
+using namespace phoenix;
+
+namespace {
+
+using Price = Decimal<4u>;
+using Volume = Decimal<4u>;
+
+// the pool as it was before the free list
+template<typename T>
+struct LegacyNodePool
+{
+    using value_type = T;
+    using size_type = std::size_t;
+
+    static LegacyNodePool& getInstance()
+    {
+        static LegacyNodePool instance{true};
+        return instance;
+    }
+
+    LegacyNodePool() = default;
+
+    template<typename U>
+    LegacyNodePool(LegacyNodePool<U> const&)
+    {}
+
+    value_type* allocate(std::size_t)
+    {
+        auto& self = getInstance();
+
+        auto curr = self.index;
+        while (!self.pool[curr].isFree)
+            curr = (curr + 1u) & PREALLOCATOR_MASK;
+
+        self.index = (curr + 1u) & PREALLOCATOR_MASK;
+        auto* freeNode = &self.pool[curr];
+        freeNode->isFree = false;
+        return &freeNode->value;
+    }
+
+    void deallocate(value_type* node, std::size_t)
+    {
+        auto& self = getInstance();
+        auto it = self.addresses.find(node);
+        self.pool[it->second].isFree = true;
+    }
+
+    template<typename U>
+    bool operator==(LegacyNodePool<U> const&) const
+    {
+        return true;
+    }
+
+private:
+    LegacyNodePool(bool)
+    {
+        pool.resize(PREALLOCATOR_SIZE);
+        for (std::size_t i = 0u; i < PREALLOCATOR_SIZE; ++i)
+            addresses[&(pool[i].value)] = i;
+        index = 0u;
+    }
+
+    struct Node
+    {
+        value_type value;
+        bool isFree = true;
+    };
+
+    static constexpr std::size_t PREALLOCATOR_SIZE = 65536u;
+    static constexpr std::size_t PREALLOCATOR_MASK = PREALLOCATOR_SIZE - 1u;
+    std::vector<Node> pool;
+    boost::unordered_flat_map<value_type const*, std::size_t> addresses;
+    std::size_t index = 0u;
+};
+
+struct Operation
+{
+    bool isErase;
+    Price price;
+    Volume volume;
+};
+
+// Levels come and go close to a drifting mid, about 40% of operations remove a resting level
+std::vector<Operation> generate(std::size_t count, std::size_t restingLevels)
+{
+    std::mt19937_64 rng{7u};
+    std::geometric_distribution<std::int64_t> distance{0.02};
+    std::uniform_int_distribution<int> coin{0, 99};
+
+    std::int64_t mid = 65'000;
+    std::set<std::int64_t> levels;
+    std::vector<Operation> operations;
+    operations.reserve(count);
+
+    auto const toPrice = [](std::int64_t tick) { return Price{static_cast<std::uint64_t>(tick) * 10'000u}; };
+
+    while (operations.size() < count)
+    {
+        if (coin(rng) < 5)
+            mid += coin(rng) < 50 ? 1 : -1;
+
+        std::int64_t const tick = mid - 1 - distance(rng);
+        bool const isErase = levels.size() >= restingLevels || (coin(rng) < 40 && !levels.empty());
+
+        if (isErase)
+        {
+            auto it = levels.lower_bound(tick);
+            if (it == levels.end())
+                it = std::prev(it);
+
+            operations.push_back({true, toPrice(*it), Volume{}});
+            levels.erase(it);
+        }
+        else
+        {
+            levels.insert(tick);
+            operations.push_back({false, toPrice(tick), Volume{1.0}});
+        }
+    }
+
+    return operations;
+}
+
+template<typename Map>
+void run(char const* name, Map& map, std::vector<Operation> const& operations)
+{
+    auto const start = std::chrono::steady_clock::now();
+
+    for (auto const& operation : operations)
+    {
+        if (operation.isErase)
+            map.erase(operation.price);
+        else
+            map[operation.price] = operation.volume;
+    }
+
+    auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << elapsed / operations.size() << " ns/operation (" << map.size() << " left)"
+              << std::endl;
+}
+
+// allocator alone: free a random live node and take a new one
+template<typename Allocator>
+void runRaw(char const* name, Allocator allocator, std::size_t count, std::size_t liveNodes)
+{
+    using Node = typename Allocator::value_type;
+
+    std::mt19937_64 rng{11u};
+    std::vector<std::size_t> victims(count);
+    for (auto& victim : victims)
+        victim = rng() % liveNodes;
+
+    std::vector<Node*> live(liveNodes);
+    for (auto& node : live)
+        node = allocator.allocate(1u);
+
+    auto const start = std::chrono::steady_clock::now();
+
+    for (std::size_t victim : victims)
+    {
+        allocator.deallocate(live[victim], 1u);
+        live[victim] = allocator.allocate(1u);
+    }
+
+    auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << elapsed / count << " ns/free+allocate" << std::endl;
+
+    for (auto* node : live)
+        allocator.deallocate(node, 1u);
+}
+
+// same size as a std::map node
+using RawNode = std::array<std::byte, 64u>;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::size_t const count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5'000'000u;
+    std::size_t const restingLevels = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2'000u;
+
+    auto const operations = generate(count, restingLevels);
+    std::cout << operations.size() << " operations, at most " << restingLevels << " resting levels" << std::endl;
+
+    {
+        std::map<Price, Volume, std::greater<>> map;
+        run("std::allocator", map, operations);
+    }
+
+    {
+        std::map<Price, Volume, std::greater<>, LegacyNodePool<std::pair<Price const, Volume>>> map;
+        run("Legacy NodePool", map, operations);
+    }
+
+    {
+        NodeArena arena;
+        std::map<Price, Volume, std::greater<>, detail::NodePool<std::pair<Price const, Volume>>> map{
+            detail::NodePool<std::pair<Price const, Volume>>{arena}};
+        run("NodePool", map, operations);
+        std::cout << "  " << arena.getNumChunks() << " chunks, " << arena.getCapacity() << " nodes" << std::endl;
+    }
+
+    {
+        NodeArena arena{true};
+        std::map<Price, Volume, std::greater<>, detail::NodePool<std::pair<Price const, Volume>>> map{
+            detail::NodePool<std::pair<Price const, Volume>>{arena}};
+        run("NodePool huge pages", map, operations);
+        std::cout << "  " << arena.getNumChunks() << " chunks, " << arena.getCapacity() << " nodes"
+                  << (arena.usesHugePages() ? "" : ", no huge pages available") << std::endl;
+    }
+
+    std::cout << "allocator only, " << restingLevels << " live nodes" << std::endl;
+    runRaw("std::allocator", std::allocator<RawNode>{}, count, restingLevels);
+    runRaw("Legacy NodePool", LegacyNodePool<RawNode>{}, count, restingLevels);
+
+    {
+        NodeArena arena;
+        runRaw("NodePool", detail::NodePool<RawNode>{arena}, count, restingLevels);
+    }
+
+    return EXIT_SUCCESS;
+}
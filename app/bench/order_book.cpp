@@ -0,0 +1,249 @@
+#include "phoenix/data/decimal.hpp"
+#include "phoenix/data/fix.hpp"
+#include "phoenix/data/ladder_book.hpp"
+#include "phoenix/data/order_book.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Update cost of LadderBook against the map based OrderBook
+// Replays 35=W/X messages from a file with one FIX message per line ('|' or SOH separated, flight recorder dumps work
+// as they are), or generates BTC-USDC like updates when no file is given
+// usage: phoenix_bench_order_book [file] [symbol] [tick size]
+
+using namespace phoenix;
+
+namespace {
+
+using Price = Decimal<4u>;
+using Volume = Decimal<4u>;
+
+struct Change
+{
+    bool isBid;
+    bool isDelete;
+    Price price;
+    Volume volume;
+};
+
+struct Message
+{
+    bool isSnapshot;
+    std::vector<Change> changes;
+};
+
+void decode(FIXReaderFast& reader, std::vector<Message>& messages)
+{
+    bool const isSnapshot = reader.isMessageType("W");
+    if (!isSnapshot && !reader.isMessageType("X"))
+        return;
+
+    Message message{.isSnapshot = isSnapshot, .changes = {}};
+    std::size_t const numUpdates = reader.getNumber<std::size_t>(268);
+    for (std::size_t i = 0u; i < numUpdates; ++i)
+    {
+        unsigned const typeField = reader.getNumber<unsigned>(269, i);
+        if (typeField > 1u)
+            continue;
+
+        // clang-format off
+        message.changes.push_back({
+            .isBid = typeField == 0u,
+            .isDelete = !isSnapshot && reader.getNumber<unsigned>(279, i) == 2u,
+            .price = reader.getDecimal<Price>(270, i),
+            .volume = reader.getDecimal<Volume>(271, i)
+        });
+        // clang-format on
+    }
+
+    messages.push_back(std::move(message));
+}
+
+std::vector<Message> load(char const* path, std::string_view symbol)
+{
+    std::vector<Message> messages;
+    std::ifstream file{path};
+    std::string line;
+    FIXReaderFast reader;
+
+    while (std::getline(file, line))
+    {
+        auto const start = line.find("8=FIX");
+        if (start == std::string::npos || line.ends_with("..."))
+            continue;
+
+        std::string msg = line.substr(start);
+        std::replace(msg.begin(), msg.end(), '|', '\x01');
+        reader.init(msg);
+
+        if (symbol.empty() || reader.getStringView(55) == symbol)
+            decode(reader, messages);
+    }
+
+    return messages;
+}
+
+// Random walk of the mid with most changes close to the top, like the BTC-USDC book
+std::vector<Message> generate(std::size_t count, std::int64_t tickRaw)
+{
+    std::mt19937_64 rng{42u};
+    std::geometric_distribution<std::int64_t> distance{0.08};
+    std::uniform_int_distribution<std::uint64_t> size{1u, 50'000u};
+    std::uniform_int_distribution<int> coin{0, 99};
+
+    std::int64_t mid = 650'000'000 / tickRaw; // 65000 in ticks
+    std::map<std::int64_t, bool> bids;
+    std::map<std::int64_t, bool> asks;
+
+    auto const toPrice = [&](std::int64_t tick) { return Price{static_cast<std::uint64_t>(tick * tickRaw)}; };
+
+    std::vector<Message> messages;
+    messages.reserve(count);
+
+    Message snapshot{.isSnapshot = true, .changes = {}};
+    for (std::int64_t i = 1; i <= 500; ++i)
+    {
+        bids[mid - i] = true;
+        asks[mid + i] = true;
+        snapshot.changes.push_back({true, false, toPrice(mid - i), Volume{size(rng)}});
+        snapshot.changes.push_back({false, false, toPrice(mid + i), Volume{size(rng)}});
+    }
+    messages.push_back(std::move(snapshot));
+
+    while (messages.size() < count)
+    {
+        Message message{.isSnapshot = false, .changes = {}};
+
+        if (coin(rng) < 10)
+        {
+            mid += coin(rng) < 50 ? 1 : -1;
+            for (auto it = bids.lower_bound(mid); it != bids.end(); it = bids.erase(it))
+                message.changes.push_back({true, true, toPrice(it->first), Volume{}});
+            for (auto it = asks.begin(); it != asks.end() && it->first <= mid; it = asks.erase(it))
+                message.changes.push_back({false, true, toPrice(it->first), Volume{}});
+        }
+
+        std::size_t const numChanges = 1u + coin(rng) % 4;
+        for (std::size_t i = 0u; i < numChanges; ++i)
+        {
+            bool const isBid = coin(rng) < 50;
+            std::int64_t const tick = isBid ? mid - 1 - distance(rng) : mid + 1 + distance(rng);
+            auto& side = isBid ? bids : asks;
+
+            // keep a few levels so both books always have a top
+            bool const isDelete = coin(rng) < 30 && side.contains(tick) && side.size() > 10u;
+            if (isDelete)
+                side.erase(tick);
+            else
+                side[tick] = true;
+
+            message.changes.push_back({isBid, isDelete, toPrice(tick), isDelete ? Volume{} : Volume{size(rng)}});
+        }
+
+        messages.push_back(std::move(message));
+    }
+
+    return messages;
+}
+
+// applies a message then reads the top, which is what the strategies do per update
+template<typename Book>
+[[gnu::always_inline]] inline std::uint64_t apply(Book& book, Message const& message)
+{
+    for (auto const& change : message.changes)
+    {
+        if (change.isBid)
+        {
+            if (change.isDelete)
+                book.popBid(change.price);
+            else
+                book.pushBid(change.price, change.volume);
+        }
+        else
+        {
+            if (change.isDelete)
+                book.popAsk(change.price);
+            else
+                book.pushAsk(change.price, change.volume);
+        }
+    }
+
+    return book.getBestBid().first.getValue() + book.getBestAsk().first.getValue();
+}
+
+template<typename Book>
+void run(char const* name, Book& book, std::vector<Message> const& messages, std::size_t numChanges)
+{
+    std::uint64_t checksum = 0u;
+    auto const start = std::chrono::steady_clock::now();
+
+    for (auto const& message : messages)
+        checksum += apply(book, message);
+
+    auto const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << elapsed / messages.size() << " ns/message, " << elapsed / numChanges
+              << " ns/level change (checksum " << checksum << ")" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string_view const symbol = argc > 2 ? argv[2] : "BTC_USDC";
+    Price const tickSize = argc > 3 ? Price{std::string_view{argv[3]}} : Price{1.0};
+
+    auto messages =
+        argc > 1 ? load(argv[1], symbol) : generate(1'000'000u, static_cast<std::int64_t>(tickSize.getValue()));
+
+    // the map book does not clear on snapshots and both need a top, start from the first snapshot
+    auto first = std::find_if(messages.begin(), messages.end(), [](auto const& m) { return m.isSnapshot; });
+    if (first == messages.end())
+    {
+        std::cerr << "No snapshot for " << symbol << std::endl;
+        return EXIT_FAILURE;
+    }
+    messages.erase(messages.begin(), first);
+    messages.erase(std::remove_if(messages.begin() + 1, messages.end(), [](auto const& m) { return m.isSnapshot; }),
+                   messages.end());
+
+    std::size_t numChanges = 0u;
+    for (auto const& message : messages)
+        numChanges += message.changes.size();
+
+    std::cout << messages.size() << " messages, " << numChanges << " level changes" << std::endl;
+
+    // both books must agree on the top after every message
+    {
+        OrderBook<Price, Volume> mapBook;
+        LadderBook<Price, Volume> ladderBook{tickSize};
+        for (auto const& message : messages)
+        {
+            apply(mapBook, message);
+            apply(ladderBook, message);
+            if (mapBook.getBestBid().first != ladderBook.getBestBid().first ||
+                mapBook.getBestAsk().first != ladderBook.getBestAsk().first)
+            {
+                std::cerr << "Books diverged" << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    OrderBook<Price, Volume> mapBook;
+    run("OrderBook", mapBook, messages, numChanges);
+
+    LadderBook<Price, Volume> ladderBook{tickSize};
+    run("LadderBook", ladderBook, messages, numChanges);
+    std::cout << "LadderBook dropped " << ladderBook.getDroppedLevels() << " levels on re-centre" << std::endl;
+
+    return EXIT_SUCCESS;
+}
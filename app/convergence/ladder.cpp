@@ -0,0 +1,59 @@
+#include "phoenix/common/exchange_latency.hpp"
+#include "phoenix/common/flight_recorder.hpp"
+#include "phoenix/common/gateway_client.hpp"
+#include "phoenix/common/logger.hpp"
+#include "phoenix/common/profiler.hpp"
+#include "phoenix/common/scheduler.hpp"
+#include "phoenix/common/session_pool.hpp"
+#include "phoenix/common/tcp_socket.hpp"
+#include "phoenix/data/decimal.hpp"
+#include "phoenix/graph/router.hpp"
+#include "phoenix/strategies/convergence/config.hpp"
+#include "phoenix/strategies/convergence/ladder_quoter.hpp"
+#include "phoenix/strategies/convergence/risk.hpp"
+#include "phoenix/strategies/convergence/stream.hpp"
+#include "phoenix/tags.hpp"
+
+using namespace phoenix;
+using namespace phoenix::convergence;
+
+struct Traits
+{
+    using PriceType = Decimal<4u>;
+    using VolumeType = Decimal<4u>;
+};
+
+// clang-format off
+using Graph = Router<
+    Config<Traits>,
+    Traits,
+    NodeList<
+        Risk,
+        TCPSocket,
+        Scheduler,
+        GatewayClient,
+        SessionPool,
+        Stream,
+        LadderQuoter,
+        ExchangeLatency,
+        Profiler,
+        Logger,
+        FlightRecorder
+    >
+>;
+// clang-format on
+
+int main(int argc, char* argv[])
+{
+    Config<Traits> config;
+    if (!config.apply(argc, argv))
+        return 1;
+
+    Graph graph{config};
+    auto* handler = graph.getHandler();
+
+    handler->invoke(tag::Logger::Start{}, false, true);
+    handler->invoke(tag::FlightRecorder::Start{});
+    PHOENIX_LOG_INFO(handler, "Starting Ladder Convergence Arbitrage System");
+    handler->invoke(tag::Stream::Start{});
+}
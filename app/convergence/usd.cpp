@@ -1,5 +1,10 @@
+#include "phoenix/common/exchange_latency.hpp"
+#include "phoenix/common/flight_recorder.hpp"
+#include "phoenix/common/gateway_client.hpp"
 #include "phoenix/common/logger.hpp"
 #include "phoenix/common/profiler.hpp"
+#include "phoenix/common/scheduler.hpp"
+#include "phoenix/common/session_pool.hpp"
 #include "phoenix/common/tcp_socket.hpp"
 #include "phoenix/data/decimal.hpp"
 #include "phoenix/graph/router.hpp"
@@ -25,10 +30,15 @@ using Graph = Router<
     NodeList<
         Risk,
         TCPSocket,
+        Scheduler,
+        GatewayClient,
+        SessionPool,
         Stream,
         Quoter,
+        ExchangeLatency,
         Profiler,
-        Logger
+        Logger,
+        FlightRecorder
     >
 >;
 // clang-format on
@@ -43,6 +53,7 @@ int main(int argc, char* argv[])
     auto* handler = graph.getHandler();
 
     handler->invoke(tag::Logger::Start{}, false, true);
+    handler->invoke(tag::FlightRecorder::Start{});
     PHOENIX_LOG_INFO(handler, "Starting USD Convergence Arbitrage System");
     handler->invoke(tag::Stream::Start{});
 }
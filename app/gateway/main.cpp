@@ -0,0 +1,64 @@
+#include "phoenix/common/flight_recorder.hpp"
+#include "phoenix/common/logger.hpp"
+#include "phoenix/common/profiler.hpp"
+#include "phoenix/common/tcp_socket.hpp"
+#include "phoenix/data/decimal.hpp"
+#include "phoenix/graph/router.hpp"
+#include "phoenix/strategies/gateway/config.hpp"
+#include "phoenix/strategies/gateway/risk.hpp"
+#include "phoenix/strategies/gateway/stream.hpp"
+#include "phoenix/tags.hpp"
+#include "phoenix/utils.hpp"
+
+#include <cstring>
+#include <iostream>
+
+#include <pthread.h>
+
+// One order session for every strategy process on the account, see gateway in the strategy configs
+
+using namespace phoenix;
+using namespace phoenix::gateway;
+
+// orders arrive already formatted, the gateway never does arithmetic on them
+struct DummyTraits
+{};
+
+// clang-format off
+using Graph = Router<
+    Config<DummyTraits>,
+    DummyTraits,
+    NodeList<
+        TCPSocket,
+        Stream,
+        Risk,
+        Profiler,
+        Logger,
+        FlightRecorder
+    >
+>;
+// clang-format on
+
+int main(int argc, char* argv[])
+{
+    Config<DummyTraits> config;
+    if (!config.apply(argc, argv))
+        return 1;
+
+    Graph graph{config};
+    auto* handler = graph.getHandler();
+
+    handler->invoke(tag::Logger::Start{});
+    handler->invoke(tag::FlightRecorder::Start{});
+    PHOENIX_LOG_INFO(handler, "Starting Order Gateway");
+
+    setMaxThreadPriority();
+    if (config.cpu >= 0)
+    {
+        if (int const error = setThreadAffinity(pthread_self(), config.cpu))
+            std::cerr << "Failed to pin the gateway to CPU " << config.cpu << ": " << std::strerror(error) << std::endl;
+    }
+
+    handler->invoke(tag::Stream::Start{});
+    return 0;
+}
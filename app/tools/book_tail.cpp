@@ -0,0 +1,100 @@
+#include "phoenix/tools/shm_books.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Prints every change of the books published by a trading process with book-shm set
+// usage: phoenix_book_tail <shm name> [levels] [symbol...]
+
+using namespace phoenix;
+
+namespace {
+
+constexpr std::chrono::milliseconds POLL_INTERVAL{1u};
+
+std::string formatTime(std::int64_t ns)
+{
+    std::time_t const seconds = ns / 1'000'000'000;
+    std::stringstream ss;
+    ss << std::put_time(std::gmtime(&seconds), "%H:%M:%S") << '.' << std::setw(3) << std::setfill('0')
+       << (ns / 1'000'000) % 1000;
+    return ss.str();
+}
+
+void print(ShmBookReader const& reader, ShmBook const& book, std::size_t levels)
+{
+    double const priceMultiplier = reader.getPriceMultiplier();
+    double const volumeMultiplier = reader.getVolumeMultiplier();
+
+    auto const printSide = [&](ShmLevel const* side, std::uint32_t count)
+    {
+        for (std::size_t i = 0u; i < std::min<std::size_t>(count, levels); ++i)
+            std::cout << ' ' << side[i].volume / volumeMultiplier << '@' << side[i].price / priceMultiplier;
+    };
+
+    std::cout << formatTime(book.timestamp) << ' ' << std::left << std::setw(16) << book.symbol << std::right
+              << " bids";
+    printSide(book.bids, book.numBids);
+    std::cout << " | asks";
+    printSide(book.asks, book.numAsks);
+    std::cout << '\n';
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <shm name> [levels] [symbol...]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::size_t const levels = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : ShmBook::DEPTH;
+    std::vector<std::string_view> symbols{argv + std::min(argc, 3), argv + argc};
+
+    ShmBookReader reader;
+    if (int const error = reader.open(argv[1]))
+    {
+        std::cerr << "Failed to open " << argv[1] << ": " << std::strerror(error) << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto const isWanted = [&](std::string_view symbol)
+    { return symbols.empty() || std::find(symbols.begin(), symbols.end(), symbol) != symbols.end(); };
+
+    std::vector<std::uint64_t> versions(ShmBooks::MAX_BOOKS, 0u);
+    while (true)
+    {
+        bool changed = false;
+        for (std::size_t i = 0u; i < reader.getNumBooks(); ++i)
+        {
+            std::uint64_t const version = reader.getVersion(i);
+            if (version == versions[i])
+                continue;
+
+            versions[i] = version;
+            auto const book = reader.read(i);
+            if (!book.timestamp || !isWanted(book.symbol))
+                continue;
+
+            print(reader, book, levels);
+            changed = true;
+        }
+
+        if (changed)
+            std::cout << std::flush;
+        else
+            std::this_thread::sleep_for(POLL_INTERVAL);
+    }
+}
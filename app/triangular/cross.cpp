@@ -1,13 +1,5 @@
-#include "phoenix/common/logger.hpp"
-#include "phoenix/common/profiler.hpp"
-#include "phoenix/common/tcp_socket.hpp"
 #include "phoenix/data/decimal.hpp"
-#include "phoenix/graph/router.hpp"
-#include "phoenix/strategies/triangular/cross/hitter.hpp"
-#include "phoenix/strategies/triangular/config.hpp"
-#include "phoenix/strategies/triangular/risk.hpp"
-#include "phoenix/strategies/triangular/stream.hpp"
-#include "phoenix/utils.hpp"
+#include "phoenix/strategies/triangular/run.hpp"
 
 using namespace phoenix;
 using namespace phoenix::triangular;
@@ -16,35 +8,20 @@ struct Traits
 {
     using PriceType = Decimal<4u>;
     using VolumeType = Decimal<4u>;
-};
-
-// clang-format off
-using Graph = Router<
-    Config<Traits>,
-    Traits,
-    NodeList<
-        TCPSocket,
-        Stream,
-        Hitter,
-        Risk,
-        Logger,
-        Profiler
-    >
->;
-// clang-format on
 
-int main(int argc, char* argv[])
-{
-    Config<Traits> config;
-    if (!config.apply(argc, argv))
-        return 1;
-
-    Graph graph{config};
-    auto* handler = graph.getHandler();
+    // ETH = BTC * ETH/BTC, the BTC leg trades volume-size as given and the ETH legs are whole contracts worth it
+    // clang-format off
+    static constexpr Triangle<3u> TRIANGLE{
+        .legs = {{
+            {.exponent = -1},
+            {.exponent = 1, .volumeOf = 0u, .byNotional = true, .lotSize = 1.0},
+            {.exponent = -1, .volumeOf = 1u, .lotSize = 1.0, .minQty = 200.0},
+        }},
+        .sizing = Sizing::BOOK,
+        .pnlLeg = 1u,
+        .pnlCurrency = "USD",
+    };
+    // clang-format on
+};
 
-    handler->invoke(tag::Logger::Start{});
-    PHOENIX_LOG_INFO(handler, "Starting BTC/ETH Triangular Arbitrage System");
-    
-    setMaxThreadPriority();
-    handler->invoke(tag::Stream::Start{});
-}
+int main(int argc, char* argv[]) { return run<Traits>(argc, argv, "BTC/ETH Triangular"); }
@@ -0,0 +1,14 @@
+#include "phoenix/data/decimal.hpp"
+#include "phoenix/strategies/triangular/cycles/hitter.hpp"
+#include "phoenix/strategies/triangular/run.hpp"
+
+using namespace phoenix;
+using namespace phoenix::triangular;
+
+struct Traits
+{
+    using PriceType = Decimal<4u>;
+    using VolumeType = Decimal<4u>;
+};
+
+int main(int argc, char* argv[]) { return run<Traits, CycleHitter>(argc, argv, "Cycle"); }
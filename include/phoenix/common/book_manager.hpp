@@ -0,0 +1,218 @@
+#pragma once
+
+#include "phoenix/common/logger.hpp"
+#include "phoenix/data/fix.hpp"
+#include "phoenix/data/order_book.hpp"
+#include "phoenix/tags.hpp"
+#include "phoenix/tools/seqlock.hpp"
+#include "phoenix/tools/shm_books.hpp"
+#include "phoenix/tools/tracepoints.hpp"
+
+#include <boost/unordered/unordered_flat_map.hpp>
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace phoenix {
+
+using InstrumentId = std::uint32_t;
+
+// IDs are dense, always below this
+inline constexpr std::size_t MAX_INSTRUMENTS = 64u;
+
+// Best levels of one instrument, an empty side reads as a zero bid or a max ask
+template<typename Price, typename Volume>
+struct TopOfBook
+{
+    Price bid{typename Price::ValueType{}};
+    Volume bidQty{};
+    Price ask{std::numeric_limits<typename Price::ValueType>::max()};
+    Volume askQty{};
+};
+
+// Owns one book per instrument, instruments are interned to dense integer IDs once and looked up by ID after
+// Market data goes in through Apply, and only the nodes subscribed to the instrument are told about the change
+// Tops are published through a seqlock each, so other threads can read them without sharing a line with another instrument
+// With book-shm set, the top levels of every book are also published to shared memory for other processes
+template<typename NodeBase>
+struct BookManager : NodeBase
+{
+    using NodeBase::NodeBase;
+
+    using Price = NodeBase::Traits::PriceType;
+    using Volume = NodeBase::Traits::VolumeType;
+    using Book = OrderBook<Price, Volume>;
+    using Top = TopOfBook<Price, Volume>;
+
+    static constexpr std::size_t MAX_SUBSCRIBERS = 4u;
+    static_assert(MAX_INSTRUMENTS <= 64u, "Pending instruments are one bit each");
+
+    void handle(tag::BookManager::Start)
+    {
+        auto* handler = this->getHandler();
+        auto const& shmName = this->getConfig()->bookShm;
+        if (shmName.empty())
+            return;
+
+        int const error = shm.open(shmName, Price{1.0}.getValue(), Volume{1.0}.getValue());
+        PHOENIX_LOG_VERIFY(handler, (!error), "Failed to open shared memory", shmName, std::strerror(error));
+        PHOENIX_LOG_INFO(handler, "Publishing books to shared memory", shmName);
+
+        // instruments interned before the start
+        for (auto const& instrument : instruments)
+            shm.add(instrument->symbol);
+    }
+
+    InstrumentId handle(tag::BookManager::Intern, std::string_view symbol)
+    {
+        if (auto const it = ids.find(symbol); it != ids.end())
+            return it->second;
+
+        auto* handler = this->getHandler();
+        PHOENIX_LOG_VERIFY(handler, (instruments.size() < MAX_INSTRUMENTS), "Too many instruments for", symbol);
+
+        auto const id = static_cast<InstrumentId>(instruments.size());
+        auto& instrument = instruments.emplace_back(std::make_unique<Instrument>());
+        instrument->symbol = symbol;
+        ids[instrument->symbol] = id;
+
+        // same index as the ID while both have the same capacity
+        static_assert(MAX_INSTRUMENTS <= ShmBooks::MAX_BOOKS);
+        if (shm.isOpen())
+            shm.add(instrument->symbol);
+
+        handler->invoke(tag::ExchangeLatency::Name{}, id, symbol);
+        PHOENIX_LOG_INFO(handler, "Interned", symbol, "as", id);
+        return id;
+    }
+
+    // the subscriber receives handle(tag::BookManager::Changed, InstrumentId) after every applied message
+    template<typename Subscriber>
+    void handle(tag::BookManager::Subscribe, InstrumentId id, Subscriber* subscriber)
+    {
+        auto& instrument = *instruments[id];
+        auto* handler = this->getHandler();
+        PHOENIX_LOG_VERIFY(handler, (instrument.numSubscribers < MAX_SUBSCRIBERS), "Too many subscribers for", instrument.symbol);
+
+        auto& entry = instrument.subscribers[instrument.numSubscribers++];
+        entry.node = subscriber;
+        entry.notify = [](void* node, InstrumentId changed)
+        { static_cast<Subscriber*>(node)->handle(tag::BookManager::Changed{}, changed); };
+    }
+
+    // W snapshots replace the book, X incrementals are applied on top
+    // Without notify the instrument is only marked, and its subscribers are told once on the next Flush
+    [[gnu::hot]]
+    void handle(tag::BookManager::Apply, FIXReaderFast& marketData, bool const notify = true)
+    {
+        auto* handler = this->getHandler();
+        auto const symbol = marketData.getStringView(55);
+        auto const it = ids.find(symbol);
+        if (it == ids.end()) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "Market data for unknown instrument", symbol);
+            return;
+        }
+
+        InstrumentId const id = it->second;
+        handler->retrieve(tag::ExchangeLatency::Record{}, id, marketData.getStringView(52));
+
+        auto& instrument = *instruments[id];
+        auto& book = instrument.book;
+        {
+            [[maybe_unused]] auto counters = handler->retrieve(tag::PerfCounters::Guard{}, "book update");
+            if (marketData.isMessageType("W"))
+                book.fromSnapshot(marketData);
+            else
+                book.fromUpdate(marketData);
+        }
+
+        if (!book.getNumBids() || !book.getNumAsks()) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "Invalid prices");
+            return;
+        }
+
+        PHOENIX_TRACE(md_update, id);
+        auto const& [bid, bidQty] = book.getBestBid();
+        auto const& [ask, askQty] = book.getBestAsk();
+        tops[id].store({bid, bidQty, ask, askQty});
+
+        if (shm.isOpen())
+            shm.publish(id, book);
+
+        if (!notify)
+        {
+            std::uint64_t const bit = 1ull << id;
+            conflated += (pending & bit) != 0u;
+            pending |= bit;
+            return;
+        }
+
+        notifySubscribers(id);
+    }
+
+    // One notification per instrument applied since the last flush, however many updates it took
+    [[gnu::hot]]
+    void handle(tag::BookManager::Flush)
+    {
+        while (pending)
+        {
+            auto const id = static_cast<InstrumentId>(std::countr_zero(pending));
+            pending &= pending - 1u;
+            notifySubscribers(id);
+        }
+    }
+
+    // updates applied without their own notification since the start
+    std::uint64_t handle(tag::BookManager::GetConflated) const { return conflated; }
+
+    // trading thread only
+    Book const* handle(tag::BookManager::GetBook, InstrumentId id) const { return &instruments[id]->book; }
+
+    // get() on the trading thread, load() from any other thread
+    Seqlock<Top> const* handle(tag::BookManager::GetTop, InstrumentId id) const { return &tops[id]; }
+
+private:
+    [[gnu::hot, gnu::always_inline]]
+    inline void notifySubscribers(InstrumentId id)
+    {
+        auto& instrument = *instruments[id];
+        for (std::size_t i = 0u; i < instrument.numSubscribers; ++i)
+            instrument.subscribers[i].notify(instrument.subscribers[i].node, id);
+    }
+
+    struct Subscriber
+    {
+        void* node = nullptr;
+        void (*notify)(void*, InstrumentId) = nullptr;
+    };
+
+    struct Instrument
+    {
+        Book book;
+        std::array<Subscriber, MAX_SUBSCRIBERS> subscribers{};
+        std::size_t numSubscribers = 0u;
+        std::string symbol;
+    };
+
+    // heap allocated so that symbols, books and tops never move once handed out
+    std::vector<std::unique_ptr<Instrument>> instruments;
+    std::unique_ptr<Seqlock<Top>[]> tops{new Seqlock<Top>[MAX_INSTRUMENTS]};
+    boost::unordered_flat_map<std::string_view, InstrumentId> ids;
+    ShmBookWriter shm;
+
+    // instruments applied without notify, by ID
+    std::uint64_t pending = 0u;
+    std::uint64_t conflated = 0u;
+};
+
+} // namespace phoenix
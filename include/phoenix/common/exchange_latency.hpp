@@ -0,0 +1,114 @@
+#pragma once
+
+#include "phoenix/common/book_manager.hpp"
+#include "phoenix/common/logger.hpp"
+#include "phoenix/data/fix.hpp"
+#include "phoenix/tags.hpp"
+#include "phoenix/tools/latency_histogram.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <time.h>
+
+namespace phoenix {
+
+// latency stream of the execution reports, after the instrument IDs
+inline constexpr std::size_t EXECUTION_REPORT_STREAM = MAX_INSTRUMENTS;
+
+// strategies on a single instrument without a BookManager record it here
+inline constexpr std::size_t INSTRUMENT_STREAM = 0u;
+
+// Exchange to local latency from SendingTime (52), one stream per instrument ID plus one for execution reports
+// Includes the clock offset to the exchange, so it's an estimate that is only as good as our NTP/PTP sync
+// Books whose last update took longer than stale-threshold-us are stale, and strategies skip triggering on them
+template<typename NodeBase>
+struct ExchangeLatency : NodeBase
+{
+    using NodeBase::NodeBase;
+
+    static constexpr std::size_t MAX_STREAMS = EXECUTION_REPORT_STREAM + 1u;
+
+    // weight of the newest sample in the moving estimate
+    static constexpr double ESTIMATE_WEIGHT = 1.0 / 32.0;
+
+    void handle(tag::ExchangeLatency::Name, std::size_t stream, std::string_view name) { streams[stream].name = name; }
+
+    // latency of the message in ns, 0 without a SendingTime
+    [[gnu::hot, gnu::always_inline]]
+    inline std::int64_t handle(tag::ExchangeLatency::Record, std::size_t stream, std::string_view sendingTime)
+    {
+        std::int64_t const sent = parseUTCTimestamp(sendingTime);
+        if (!sent) [[unlikely]]
+            return 0;
+
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        std::int64_t const latency = ts.tv_sec * 1'000'000'000 + ts.tv_nsec - sent;
+
+        auto& entry = streams[stream];
+        entry.histogram.record(latency);
+        entry.last = latency;
+        entry.estimate += (static_cast<double>(latency) - entry.estimate) * ESTIMATE_WEIGHT;
+        return latency;
+    }
+
+    // whether the last message of the stream arrived later than stale-threshold-us, always false at 0
+    [[gnu::hot, gnu::always_inline]]
+    inline bool handle(tag::ExchangeLatency::IsStale, std::size_t stream)
+    {
+        std::int64_t const threshold = std::int64_t{this->getConfig()->staleThresholdUs} * 1'000;
+        return threshold && streams[stream].last > threshold;
+    }
+
+    // Logs the histogram of every stream with samples since the last report, then starts them over
+    void handle(tag::ExchangeLatency::Report)
+    {
+        auto* handler = this->getHandler();
+        for (std::size_t i = 0u; i < MAX_STREAMS; ++i)
+        {
+            auto& entry = streams[i];
+            auto& histogram = entry.histogram;
+            if (!histogram.getCount())
+                continue;
+
+            std::string_view const name = i == EXECUTION_REPORT_STREAM ? "execution reports" : std::string_view{entry.name};
+            PHOENIX_LOG_INFO(
+                handler,
+                "[LATENCY]",
+                name,
+                "count",
+                histogram.getCount(),
+                "p50",
+                histogram.getQuantile(0.5),
+                "p90",
+                histogram.getQuantile(0.9),
+                "p99",
+                histogram.getQuantile(0.99),
+                "max",
+                histogram.getMax(),
+                "estimate",
+                static_cast<std::int64_t>(entry.estimate),
+                "ns, negative",
+                histogram.getNumNegative());
+
+            histogram.reset();
+        }
+    }
+
+private:
+    struct Stream
+    {
+        LatencyHistogram histogram;
+        std::int64_t last = 0;
+        double estimate = 0.0;
+        std::string name;
+    };
+
+    std::unique_ptr<Stream[]> streams{new Stream[MAX_STREAMS]};
+};
+
+} // namespace phoenix
@@ -0,0 +1,430 @@
+#pragma once
+
+#include "phoenix/common/logger.hpp"
+#include "phoenix/tags.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <x86intrin.h>
+
+namespace phoenix {
+
+namespace detail {
+// Fixed size text formatting that is safe to use inside a signal handler
+struct SignalSafeWriter
+{
+    explicit SignalSafeWriter(int fd)
+        : fd{fd}
+    {}
+
+    ~SignalSafeWriter() { flush(); }
+
+    void append(std::string_view text)
+    {
+        for (char c : text)
+            append(c);
+    }
+
+    void append(char c)
+    {
+        if (size == buffer.size())
+            flush();
+
+        buffer[size++] = c;
+    }
+
+    void append(std::uint64_t value)
+    {
+        char digits[20];
+        std::size_t n = 0u;
+        do
+        {
+            digits[n++] = static_cast<char>('0' + value % 10u);
+            value /= 10u;
+        }
+        while (value);
+
+        while (n)
+            append(digits[--n]);
+    }
+
+    void append(std::int64_t value)
+    {
+        if (value < 0)
+        {
+            // negated unsigned, so the lowest value doesn't overflow
+            append('-');
+            append(0u - static_cast<std::uint64_t>(value));
+        }
+        else
+            append(static_cast<std::uint64_t>(value));
+    }
+
+    // fixed point with 8 decimals, enough for prices and volumes
+    // values a uint64 can't hold are written as a marker, their cast would be undefined
+    void append(double value)
+    {
+        if (std::isnan(value))
+        {
+            append(std::string_view{"nan"});
+            return;
+        }
+
+        if (value < 0.0)
+        {
+            append('-');
+            value = -value;
+        }
+
+        if (std::isinf(value))
+        {
+            append(std::string_view{"inf"});
+            return;
+        }
+
+        if (value >= MAX_WHOLE)
+        {
+            append(std::string_view{"overflow"});
+            return;
+        }
+
+        auto whole = static_cast<std::uint64_t>(value);
+        auto fraction = static_cast<std::uint64_t>((value - static_cast<double>(whole)) * 1e8 + 0.5);
+
+        // rounded up into the next whole
+        if (fraction == 100'000'000u)
+        {
+            ++whole;
+            fraction = 0u;
+        }
+
+        append(whole);
+        append('.');
+
+        char digits[8];
+        for (std::size_t i = 8u; i > 0u; --i)
+        {
+            digits[i - 1u] = static_cast<char>('0' + fraction % 10u);
+            fraction /= 10u;
+        }
+
+        append(std::string_view{digits, 8u});
+    }
+
+    void flush()
+    {
+        std::size_t written = 0u;
+        while (written < size)
+        {
+            ssize_t const result = ::write(fd, buffer.data() + written, size - written);
+            if (result <= 0)
+                break;
+
+            written += result;
+        }
+
+        size = 0u;
+    }
+
+    // 2^63, whole parts below it fit a uint64 with room for the rounding carry
+    static constexpr double MAX_WHOLE = 9'223'372'036'854'775'808.0;
+
+    int const fd;
+    std::array<char, 4096u> buffer;
+    std::size_t size = 0u;
+};
+} // namespace detail
+
+// Always-on record of the last inbound messages, outbound messages and trading decisions
+// Written by the trading thread only, and dumped as text on abort, a fatal verify or a fatal signal
+template<typename NodeBase>
+struct FlightRecorder : NodeBase
+{
+    using NodeBase::NodeBase;
+
+    enum class Kind : std::uint8_t
+    {
+        INBOUND,
+        OUTBOUND,
+        DECISION
+    };
+
+    static constexpr std::size_t MAX_VALUES = 4u;
+
+    ~FlightRecorder()
+    {
+        if (INSTANCE == this)
+            INSTANCE = nullptr;
+    }
+
+    void handle(tag::FlightRecorder::Start)
+    {
+        auto* config = this->getConfig();
+
+        auto now = std::chrono::system_clock::now();
+        auto inTimeT = std::chrono::system_clock::to_time_t(now);
+
+        std::stringstream ss;
+        ss << config->logFolder << "/FLIGHT-" << config->instrument << "-"
+           << std::put_time(std::gmtime(&inTimeT), "%Y-%m-%dT%H:%M:%SZ") << ".txt";
+        dumpPath = ss.str();
+
+        slots.reset(new Slot[NUM_SLOTS]);
+        std::memset(slots.get(), 0, sizeof(Slot) * NUM_SLOTS); // prefault
+        startTsc = __rdtsc();
+        startNs = realtimeNs();
+
+        INSTANCE = this;
+        for (int signal : SIGNALS)
+        {
+            struct sigaction action;
+            std::memset(&action, 0, sizeof(action));
+            action.sa_handler = &FlightRecorder::onSignal;
+            action.sa_flags = SA_RESETHAND;
+            sigemptyset(&action.sa_mask);
+            sigaction(signal, &action, nullptr);
+        }
+
+        PHOENIX_LOG_INFO(this->getHandler(), "Flight recorder dumps to", dumpPath);
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void handle(tag::FlightRecorder::Inbound, std::string_view msg)
+    {
+        recordBytes(Kind::INBOUND, msg);
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void handle(tag::FlightRecorder::Outbound, std::string_view msg)
+    {
+        recordBytes(Kind::OUTBOUND, msg);
+    }
+
+    // label must have static storage, values are anything convertible to double
+    template<typename... Values>
+    [[gnu::hot, gnu::always_inline]]
+    inline void handle(tag::FlightRecorder::Decision, std::string_view label, Values const&... values)
+    {
+        static_assert(sizeof...(Values) <= MAX_VALUES, "Too many decision values");
+        if (!slots) [[unlikely]]
+            return;
+
+        Slot& slot = nextSlot(Kind::DECISION);
+        slot.decision.label = label.data();
+        slot.decision.labelLength = static_cast<std::uint32_t>(label.size());
+        slot.decision.numValues = sizeof...(Values);
+
+        std::size_t i = 0u;
+        ((slot.decision.values[i++] = toDouble(values)), ...);
+        publish();
+    }
+
+    void handle(tag::FlightRecorder::Dump, std::string_view reason) { dump(reason); }
+
+private:
+    static constexpr std::size_t SLOT_SIZE = 512u;
+    static constexpr std::size_t NUM_SLOTS = 2048u;
+    static constexpr std::size_t MASK = NUM_SLOTS - 1u;
+    static constexpr int SIGNALS[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT, SIGTERM, SIGINT};
+
+    struct Header
+    {
+        std::uint64_t tsc;
+        std::uint32_t length; // original length, the payload may be truncated
+        Kind kind;
+    };
+
+    struct Decision
+    {
+        char const* label;
+        std::uint32_t labelLength;
+        std::uint32_t numValues;
+        double values[MAX_VALUES];
+    };
+
+    static constexpr std::size_t MAX_PAYLOAD = SLOT_SIZE - sizeof(Header);
+
+    struct alignas(64) Slot
+    {
+        Header header;
+        union
+        {
+            char bytes[MAX_PAYLOAD];
+            Decision decision;
+        };
+    };
+
+    static_assert(sizeof(Slot) == SLOT_SIZE);
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void recordBytes(Kind kind, std::string_view msg)
+    {
+        if (!slots) [[unlikely]]
+            return;
+
+        Slot& slot = nextSlot(kind);
+        slot.header.length = static_cast<std::uint32_t>(msg.size());
+        std::memcpy(slot.bytes, msg.data(), std::min(msg.size(), MAX_PAYLOAD));
+        publish();
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline Slot& nextSlot(Kind kind)
+    {
+        Slot& slot = slots[written.load(std::memory_order_relaxed) & MASK];
+        slot.header.tsc = __rdtsc();
+        slot.header.kind = kind;
+        return slot;
+    }
+
+    // a dump from another thread or a signal may still see the slot being written, which is fine post mortem
+    [[gnu::hot, gnu::always_inline]]
+    inline void publish()
+    {
+        written.store(written.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+    }
+
+    template<typename T>
+    static double toDouble(T const& value)
+    {
+        if constexpr (requires { value.asDouble(); })
+            return value.asDouble();
+        else
+            return static_cast<double>(value);
+    }
+
+    static std::int64_t realtimeNs()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        return ts.tv_sec * 1'000'000'000 + ts.tv_nsec;
+    }
+
+    static std::string_view signalName(int signal)
+    {
+        switch (signal)
+        {
+        case SIGSEGV: return "SIGSEGV";
+        case SIGBUS: return "SIGBUS";
+        case SIGFPE: return "SIGFPE";
+        case SIGILL: return "SIGILL";
+        case SIGABRT: return "SIGABRT";
+        case SIGTERM: return "SIGTERM";
+        case SIGINT: return "SIGINT";
+        default: return "signal";
+        }
+    }
+
+    static void onSignal(int signal)
+    {
+        if (auto* recorder = INSTANCE)
+            recorder->dump(signalName(signal));
+
+        // SA_RESETHAND restored the default action
+        raise(signal);
+    }
+
+    // Only async signal safe calls from here on
+    void dump(std::string_view reason)
+    {
+        if (!slots || dumped.test_and_set())
+            return;
+
+        int const fd = ::open(dumpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return;
+
+        // rdtsc to wall clock from the rate measured since start
+        std::uint64_t const endTsc = __rdtsc();
+        std::int64_t const endNs = realtimeNs();
+        double const nsPerTick =
+            endTsc > startTsc ? static_cast<double>(endNs - startNs) / static_cast<double>(endTsc - startTsc) : 0.0;
+
+        std::uint64_t const end = written.load(std::memory_order_acquire);
+        std::uint64_t const begin = end > NUM_SLOTS ? end - NUM_SLOTS : 0u;
+
+        detail::SignalSafeWriter out{fd};
+        out.append("# flight recorder dump, reason ");
+        out.append(reason);
+        out.append(", records ");
+        out.append(end - begin);
+        out.append(" of ");
+        out.append(end);
+        out.append('\n');
+
+        for (std::uint64_t i = begin; i < end; ++i)
+        {
+            Slot const& slot = slots[i & MASK];
+            auto const ns = startNs + static_cast<std::int64_t>(static_cast<double>(slot.header.tsc - startTsc) * nsPerTick);
+
+            out.append(ns);
+            out.append(' ');
+
+            switch (slot.header.kind)
+            {
+            case Kind::INBOUND:
+            case Kind::OUTBOUND:
+            {
+                out.append(slot.header.kind == Kind::INBOUND ? "IN " : "OUT ");
+                out.append(static_cast<std::uint64_t>(slot.header.length));
+                out.append(' ');
+
+                // SOH as '|' like the usual FIX log format
+                std::size_t const length = std::min<std::size_t>(slot.header.length, MAX_PAYLOAD);
+                for (std::size_t j = 0u; j < length; ++j)
+                    out.append(slot.bytes[j] == '\x01' ? '|' : slot.bytes[j]);
+
+                if (length < slot.header.length)
+                    out.append("...");
+            }
+            break;
+
+            case Kind::DECISION:
+            {
+                auto const& decision = slot.decision;
+                out.append("DECISION ");
+                out.append(std::string_view{decision.label, decision.labelLength});
+                for (std::uint32_t j = 0u; j < std::min<std::uint32_t>(decision.numValues, MAX_VALUES); ++j)
+                {
+                    out.append(' ');
+                    out.append(decision.values[j]);
+                }
+            }
+            break;
+            }
+
+            out.append('\n');
+        }
+
+        out.flush();
+        ::close(fd);
+    }
+
+    static inline FlightRecorder* INSTANCE = nullptr;
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<std::uint64_t> written{0u};
+    std::uint64_t startTsc = 0u;
+    std::int64_t startNs = 0;
+
+    std::string dumpPath;
+    std::atomic_flag dumped = ATOMIC_FLAG_INIT;
+};
+
+} // namespace phoenix
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "phoenix/common/logger.hpp"
+#include "phoenix/data/gateway.hpp"
+#include "phoenix/data/orders.hpp"
+#include "phoenix/tags.hpp"
+#include "phoenix/tools/shm_region.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+
+namespace phoenix {
+
+// Strategy end of a GatewayChannel, with gateway set the orders go to the order gateway process instead of our own session
+// The gateway owns the account's rate limit, the session here still receives market data and keeps itself alive
+// Reports come back in the order they arrived at the gateway, a returned report stays valid until the next Receive
+// Quotes are refused while the gateway still holds earlier ones of the channel, so they wait in the Scheduler of the strategy,
+// where a newer quote can still take their place
+// A channel the gateway retired or replaced on a restart is fatal, strategies are restarted along with the gateway
+template<typename NodeBase>
+struct GatewayClient : NodeBase
+{
+    using NodeBase::NodeBase;
+
+    using Traits = NodeBase::Traits;
+
+    // orders of one batch, as many as the ladder or the longest cycle send at once
+    static constexpr std::size_t MAX_BATCH = 8u;
+
+    void handle(tag::Gateway::Start)
+    {
+        auto* handler = this->getHandler();
+        auto const& name = this->getConfig()->gateway;
+        if (name.empty())
+            return;
+
+        // the gateway may still be creating the channel, it's usable once the magic is there
+        auto const deadline = std::chrono::steady_clock::now() + ATTACH_TIMEOUT;
+        int error = region.open(name, sizeof(GatewayChannel));
+        while ((error || !isPublished()) && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(ATTACH_POLL);
+            error = region.open(name, sizeof(GatewayChannel));
+        }
+
+        PHOENIX_LOG_VERIFY(handler, (!error), "Failed to open gateway channel", name, std::strerror(error));
+        PHOENIX_LOG_VERIFY(handler, isPublished(), "Gateway channel never published", name);
+
+        auto* mapped = static_cast<GatewayChannel*>(region.get());
+        PHOENIX_LOG_VERIFY(handler, (mapped->header.version == GatewayChannel::VERSION), "Gateway channel of another layout", name);
+
+        channel = mapped;
+        epoch = channel->header.epoch;
+        PHOENIX_LOG_INFO(handler, "Sending orders through gateway", name, "route", channel->header.route);
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline bool handle(tag::Gateway::IsEnabled) const { return channel; }
+
+    // every order or none, false when the gateway is too far behind to take them
+    template<typename... Orders>
+    [[gnu::hot, gnu::always_inline]]
+    inline bool handle(tag::Gateway::Submit, Priority priority, OrderAction action, Orders const&... orders)
+    {
+        static_assert(sizeof...(Orders) <= MAX_BATCH);
+
+        std::size_t i = 0u;
+        auto const add = [&](auto const& order)
+        {
+            toGatewayOrder(batch[i], priority, action, order, sizeof...(Orders) - i);
+            ++i;
+        };
+
+        (add(orders), ...);
+        return push(priority, sizeof...(Orders));
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline bool handle(tag::Gateway::SubmitBatch, Priority priority, std::span<OrderRequest<Traits> const> requests)
+    {
+        if (requests.size() > MAX_BATCH) [[unlikely]]
+            return false;
+
+        for (std::size_t i = 0u; i < requests.size(); ++i)
+            toGatewayOrder(batch[i], priority, requests[i].action, *requests[i].order, requests.size() - i);
+
+        return push(priority, requests.size());
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline std::optional<std::string_view> handle(tag::Gateway::Receive)
+    {
+        auto& reports = channel->reports;
+        if (hasReport)
+        {
+            reports.pop();
+            hasReport = false;
+        }
+
+        if (!reports.getAvailable())
+            return std::nullopt;
+
+        hasReport = true;
+        return reports.peek().view();
+    }
+
+private:
+    static constexpr auto ATTACH_TIMEOUT = std::chrono::seconds(5);
+    static constexpr auto ATTACH_POLL = std::chrono::milliseconds(1);
+    static constexpr auto RECHECK_INTERVAL = std::chrono::seconds(1);
+
+    bool isPublished() const
+    {
+        auto const* mapped = static_cast<GatewayChannel const*>(region.get());
+        return mapped && mapped->header.magic.load(std::memory_order_acquire) == GatewayChannel::MAGIC;
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline bool push(Priority priority, std::size_t size)
+    {
+        // a stopped gateway retires the channel, nothing pushed here would be sent
+        if (!isPublished()) [[unlikely]]
+        {
+            PHOENIX_LOG_FATAL(this->getHandler(), "Gateway channel retired, restart with the gateway", this->getConfig()->gateway);
+            return false;
+        }
+
+        auto& orders = channel->orders[static_cast<std::size_t>(priority)];
+        if (priority == Priority::QUOTE && !orders.isDrained())
+        {
+            checkEpoch();
+            return false;
+        }
+
+        if (orders.tryPush(std::span<GatewayOrder const>{batch.data(), size})) [[likely]]
+            return true;
+
+        PHOENIX_LOG_WARN(this->getHandler(), "Gateway order ring full, orders refused", size);
+        checkEpoch();
+        return false;
+    }
+
+    // A gateway that died and came back never retired our channel, it serves a new one under the same name
+    // Only looked at after a refused push and at most every RECHECK_INTERVAL, since it maps the name again
+    void checkEpoch()
+    {
+        auto const now = std::chrono::steady_clock::now();
+        if (now - lastEpochCheck < RECHECK_INTERVAL)
+            return;
+
+        lastEpochCheck = now;
+        auto const& name = this->getConfig()->gateway;
+
+        ShmRegion current;
+        if (current.open(name, sizeof(GatewayChannel), true))
+            return;
+
+        auto const& header = static_cast<GatewayChannel const*>(current.get())->header;
+        if (header.magic.load(std::memory_order_acquire) == GatewayChannel::MAGIC && header.epoch != epoch) [[unlikely]]
+            PHOENIX_LOG_FATAL(this->getHandler(), "Gateway restarted under our channel, restart with the gateway", name);
+    }
+
+    ShmRegion region;
+    GatewayChannel* channel = nullptr;
+    std::uint64_t epoch = 0u;
+    std::chrono::steady_clock::time_point lastEpochCheck{};
+    std::array<GatewayOrder, MAX_BATCH> batch{};
+    bool hasReport = false;
+};
+
+} // namespace phoenix
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "phoenix/common/log_record.hpp"
+#include "phoenix/enums/log_level.hpp"
+#include "phoenix/enums/log_overflow.hpp"
+#include "phoenix/tools/byte_ring.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+namespace phoenix::detail {
+
+// Rings of one logging thread, the logger thread is the only consumer
+// Everything outside the rings is only touched by the owning thread
+struct LogProducer
+{
+    struct Gap
+    {
+        std::uint64_t count = 0u;
+        LogLevel level = LogLevel::DEBUG;
+        std::string_view filename;
+        int line = 0;
+    };
+
+    LogProducer(std::size_t capacity, LogOverflow overflow)
+        : records{capacity}
+        , overflow{overflow}
+    {
+        if (overflow == LogOverflow::SPILL)
+            spill.emplace(capacity);
+    }
+
+    LogProducer(LogProducer const&) = delete;
+    LogProducer& operator=(LogProducer const&) = delete;
+
+    // Picks the ring for the next record according to the overflow policy
+    // Once spilling, records stay in the spill ring until it is drained to keep them in order
+    [[gnu::hot, gnu::always_inline]]
+    inline std::byte* reserve(LogLevel level, std::size_t size)
+    {
+        if (spilling) [[unlikely]]
+        {
+            if (!spill->isDrained())
+            {
+                active = &*spill;
+                return spill->reserve(size);
+            }
+
+            spilling = false;
+        }
+
+        // DEBUG and INFO leave a quarter of the ring for more important entries
+        std::size_t const headroom =
+            overflow == LogOverflow::DROP_VERBOSE && level < LogLevel::WARN ? records.getCapacity() / 4u : 0u;
+
+        active = &records;
+        if (auto* out = records.reserve(size, headroom)) [[likely]]
+            return out;
+
+        if (overflow != LogOverflow::SPILL)
+            return nullptr;
+
+        spilling = true;
+        active = &*spill;
+        return spill->reserve(size);
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void commit()
+    {
+        active->commit();
+    }
+
+    // consumer: primary records are always older than spilled ones while the primary ring is not empty
+    [[gnu::hot, gnu::always_inline]]
+    inline ByteRing* nextRing()
+    {
+        if (records.front())
+            return &records;
+
+        if (!spill || !spill->front())
+            return nullptr;
+
+        // the producer may have refilled the primary ring before spilling again
+        return records.front() ? &records : &*spill;
+    }
+
+    // consumer
+    bool empty() const { return records.empty() && (!spill || spill->empty()); }
+
+    ByteRing records;
+    std::optional<ByteRing> spill;
+    ByteRing* active = &records;
+    LogOverflow const overflow;
+    bool spilling = false;
+    Gap gap;
+};
+
+// consumer: timestamp of the record at the front of a ring
+[[gnu::hot, gnu::always_inline]]
+inline std::int64_t frontTimestamp(ByteRing& ring)
+{
+    std::int64_t timestamp;
+    std::memcpy(&timestamp, ring.front() + offsetof(LogRecord, timestamp), sizeof(timestamp));
+    return timestamp;
+}
+
+} // namespace phoenix::detail
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "phoenix/enums/log_level.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Binary log records: the producer copies raw argument bytes and the logger thread formats them
+
+namespace phoenix::detail {
+
+template<typename T>
+concept LogString = std::convertible_to<T const&, std::string_view> || std::same_as<std::decay_t<T>, char const*> ||
+                    std::same_as<std::decay_t<T>, char*>;
+
+template<typename T>
+concept LogDecimal = std::is_trivially_copyable_v<T> && std::default_initializable<T> && requires(T const& value) {
+    { value.str() } -> std::convertible_to<std::string>;
+    value.asDouble();
+};
+
+template<typename T>
+concept LogRaw = std::is_arithmetic_v<T> || std::is_enum_v<T> || LogDecimal<T>;
+
+static constexpr std::size_t LOG_MAX_STRING_LENGTH = 1024u;
+
+// arithmetic, enums and decimals are copied as is, strings are copied by value,
+// and anything else is formatted on the calling thread (slow path, allocates)
+template<typename T>
+inline decltype(auto) toLoggable(T const& value)
+{
+    if constexpr (LogRaw<T>)
+        return (value);
+    else if constexpr (std::is_pointer_v<T>)
+        return value ? std::string_view{value} : std::string_view{};
+    else if constexpr (LogString<T>)
+        return std::string_view{value};
+    else
+    {
+        std::ostringstream ss;
+        ss << value;
+        return ss.str();
+    }
+}
+
+template<typename T>
+struct LogCodec
+{
+    static_assert(LogRaw<T>, "Unsupported log argument type");
+
+    [[gnu::always_inline]]
+    static inline std::size_t size(T const&)
+    {
+        return sizeof(T);
+    }
+
+    [[gnu::always_inline]]
+    static inline std::byte* encode(std::byte* out, T const& value)
+    {
+        std::memcpy(out, &value, sizeof(T));
+        return out + sizeof(T);
+    }
+
+    static std::byte const* decode(std::byte const* in, std::ostream& os)
+    {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+
+        if constexpr (LogDecimal<T>)
+            os << value.str();
+        else
+            os << value;
+
+        return in + sizeof(T);
+    }
+};
+
+template<>
+struct LogCodec<std::string_view>
+{
+    using Length = std::uint32_t;
+
+    [[gnu::always_inline]]
+    static inline std::size_t size(std::string_view value)
+    {
+        return sizeof(Length) + std::min(value.size(), LOG_MAX_STRING_LENGTH);
+    }
+
+    [[gnu::always_inline]]
+    static inline std::byte* encode(std::byte* out, std::string_view value)
+    {
+        Length const length = std::min(value.size(), LOG_MAX_STRING_LENGTH);
+        std::memcpy(out, &length, sizeof(Length));
+        std::memcpy(out + sizeof(Length), value.data(), length);
+        return out + sizeof(Length) + length;
+    }
+
+    static std::byte const* decode(std::byte const* in, std::ostream& os)
+    {
+        Length length;
+        std::memcpy(&length, in, sizeof(Length));
+        os.write(reinterpret_cast<char const*>(in + sizeof(Length)), length);
+        return in + sizeof(Length) + length;
+    }
+};
+
+template<>
+struct LogCodec<std::string> : LogCodec<std::string_view>
+{};
+
+using LogDecoder = void (*)(std::byte const*, std::ostream&, bool);
+
+// One instantiation per argument type list, its address identifies the record format
+template<typename... Args>
+void decodeLogArgs(std::byte const* in, std::ostream& os, bool isCSV)
+{
+    bool first = true;
+    auto const decodeOne = [&]<typename T>()
+    {
+        if (!isCSV)
+            os << ' ';
+        else if (!first)
+            os << ',';
+
+        first = false;
+        in = LogCodec<T>::decode(in, os);
+    };
+
+    (decodeOne.template operator()<Args>(), ...);
+}
+
+struct LogRecord
+{
+    LogDecoder decode; // decodeLogArgs of the arguments that follow
+    char const* filename; // static storage, see PHOENIX_LOG_DETAIL_CURRENT_FILE
+    std::uint32_t filenameLength;
+    std::int32_t line;
+    std::int64_t timestamp; // ns since epoch
+    LogLevel level;
+    bool isCSV;
+};
+
+template<typename... Args>
+[[gnu::always_inline]]
+inline std::size_t logRecordSize(Args const&... args)
+{
+    return sizeof(LogRecord) + (LogCodec<Args>::size(args) + ... + 0u);
+}
+
+template<typename... Args>
+[[gnu::always_inline]]
+inline void encodeLogRecord(std::byte* out, LogRecord const& record, Args const&... args)
+{
+    std::memcpy(out, &record, sizeof(LogRecord));
+    out += sizeof(LogRecord);
+    ((out = LogCodec<Args>::encode(out, args)), ...);
+}
+
+} // namespace phoenix::detail
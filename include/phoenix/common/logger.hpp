@@ -1,30 +1,54 @@
 #pragma once
 
+#include "phoenix/common/log_producer.hpp"
+#include "phoenix/common/log_record.hpp"
+#include "phoenix/enums/log_idle.hpp"
 #include "phoenix/enums/log_level.hpp"
+#include "phoenix/enums/log_overflow.hpp"
 #include "phoenix/graph/node_base.hpp"
+#include "phoenix/graph/router_handler.hpp"
 #include "phoenix/strategies/convergence/config.hpp"
 #include "phoenix/tags.hpp"
+#include "phoenix/tools/byte_ring.hpp"
+#include "phoenix/tools/futex.hpp"
+#include "phoenix/tools/log_sink.hpp"
+#include "phoenix/utils.hpp"
 
 #include <boost/describe.hpp>
-#include <boost/lockfree/spsc_queue.hpp>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <filesystem>
-#include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <optional>
+#include <ostream>
+#include <sstream>
 #include <string_view>
 #include <thread>
+#include <type_traits>
+
+#include <unistd.h>
 
 #include <immintrin.h>
 
 namespace phoenix {
 
+// Lowest level compiled into the binary, can also be raised per graph with Traits::MIN_LOG_LEVEL
+// Calls below it are removed along with the evaluation of their arguments, FATAL is never removed
+#ifndef PHOENIX_LOG_MIN_LEVEL
+#define PHOENIX_LOG_MIN_LEVEL DEBUG
+#endif
+
 namespace detail {
 consteval std::string_view getFilename(std::string_view path)
 {
@@ -35,20 +59,51 @@ consteval std::string_view getFilename(std::string_view path)
     return path.substr(lastSlash + 1);
 }
 
+template<typename Handler>
+struct HandlerTraits;
+
+template<typename Router>
+struct HandlerTraits<RouterHandler<Router>>
+{
+    using Traits = Router::Traits;
+};
+
+template<typename Traits>
+consteval LogLevel getMinLogLevel()
+{
+    constexpr LogLevel buildLevel = LogLevel::PHOENIX_LOG_MIN_LEVEL;
+    if constexpr (requires { Traits::MIN_LOG_LEVEL; })
+        return Traits::MIN_LOG_LEVEL > buildLevel ? Traits::MIN_LOG_LEVEL : buildLevel;
+    else
+        return buildLevel;
+}
+
+template<typename HandlerPtr>
+consteval bool isLogLevelCompiled(LogLevel level)
+{
+    using Traits = HandlerTraits<std::remove_cvref_t<std::remove_pointer_t<std::remove_cvref_t<HandlerPtr>>>>::Traits;
+    return level == LogLevel::FATAL || level >= getMinLogLevel<Traits>();
+}
+
 #define PHOENIX_LOG_DETAIL_CURRENT_FILE ::phoenix::detail::getFilename(__FILE__)
+
+// compile time level first, then runtime level, and only then are the arguments evaluated
+#define PHOENIX_LOG_DETAIL(handler, level, ...) \
+    do \
+    { \
+        if constexpr (::phoenix::detail::isLogLevelCompiled<decltype(handler)>(level)) \
+            if (handler->retrieve(tag::Logger::IsEnabled{}, level)) \
+                handler->invoke(tag::Logger::Log{}, level, PHOENIX_LOG_DETAIL_CURRENT_FILE, __LINE__, __VA_ARGS__); \
+    } \
+    while (false)
 } // namespace detail
 
 // clang-format off
-#define PHOENIX_LOG_DEBUG(handler, ...) \
-    handler->invoke(tag::Logger::Log{}, LogLevel::DEBUG, PHOENIX_LOG_DETAIL_CURRENT_FILE, __LINE__, __VA_ARGS__)
-#define PHOENIX_LOG_INFO(handler, ...) \
-    handler->invoke(tag::Logger::Log{}, LogLevel::INFO, PHOENIX_LOG_DETAIL_CURRENT_FILE, __LINE__, __VA_ARGS__)
-#define PHOENIX_LOG_WARN(handler, ...) \
-    handler->invoke(tag::Logger::Log{}, LogLevel::WARN, PHOENIX_LOG_DETAIL_CURRENT_FILE, __LINE__, __VA_ARGS__)
-#define PHOENIX_LOG_ERROR(handler, ...) \
-    handler->invoke(tag::Logger::Log{}, LogLevel::ERROR, PHOENIX_LOG_DETAIL_CURRENT_FILE, __LINE__, __VA_ARGS__)
-#define PHOENIX_LOG_FATAL(handler, ...) \
-    handler->invoke(tag::Logger::Log{}, LogLevel::FATAL, PHOENIX_LOG_DETAIL_CURRENT_FILE, __LINE__, __VA_ARGS__)
+#define PHOENIX_LOG_DEBUG(handler, ...) PHOENIX_LOG_DETAIL(handler, LogLevel::DEBUG, __VA_ARGS__)
+#define PHOENIX_LOG_INFO(handler, ...) PHOENIX_LOG_DETAIL(handler, LogLevel::INFO, __VA_ARGS__)
+#define PHOENIX_LOG_WARN(handler, ...) PHOENIX_LOG_DETAIL(handler, LogLevel::WARN, __VA_ARGS__)
+#define PHOENIX_LOG_ERROR(handler, ...) PHOENIX_LOG_DETAIL(handler, LogLevel::ERROR, __VA_ARGS__)
+#define PHOENIX_LOG_FATAL(handler, ...) PHOENIX_LOG_DETAIL(handler, LogLevel::FATAL, __VA_ARGS__)
 #define PHOENIX_LOG_VERIFY(handler, condition, ...) \
     handler->invoke(tag::Logger::Verify{}, condition, PHOENIX_LOG_DETAIL_CURRENT_FILE, __LINE__, #condition, __VA_ARGS__)
 #define PHOENIX_LOG_CSV(handler, ...) \
@@ -65,7 +120,9 @@ struct Logger : NodeBase
     ~Logger()
     {
         shutdown();
-        logger->join();
+        wakeLogger();
+        if (logger && logger->joinable())
+            logger->join();
     }
 
     void handle(tag::Logger::Start, bool isCSVLogger = false, bool isSingleThreadedLogger = false)
@@ -76,9 +133,19 @@ struct Logger : NodeBase
         isSingleThreaded = isSingleThreadedLogger;
         running.test_and_set();
 
+        // every producer is allocated up front so registering a thread never allocates
+        auto* config = this->getConfig();
+        producers[0].reset(new Producer{RING_CAPACITY, config->logOverflow});
+        for (std::size_t i = 1u; i < MAX_PRODUCERS; ++i)
+            producers[i].reset(new Producer{HELPER_RING_CAPACITY, config->logOverflow});
+
+        // the starting thread is the trading thread
+        epoch = ++EPOCHS;
+        threadProducer = {.epoch = epoch, .producer = producers[0].get()};
+        numProducers.store(1u, std::memory_order_release);
+
         auto now = std::chrono::system_clock::now();
         auto inTimeT = std::chrono::system_clock::to_time_t(now);
-        auto* config = this->getConfig();
 
         std::stringstream ss;
         ss << config->logFolder;
@@ -96,24 +163,36 @@ struct Logger : NodeBase
             ss << ".log";
 
         logPath = ss.str();
-        logFile.emplace(std::ofstream(logPath, std::ios::app));
+        if (int const error = logFile.open(logPath.c_str()))
+            std::cerr << "Failed to open log file " << logPath << ": " << std::strerror(error) << std::endl;
+
+        if (config->printLogs)
+            console.attach(STDOUT_FILENO);
+
+        idle = config->logIdle;
         if (!isSingleThreaded)
+        {
             logger.emplace(&Logger::loggerThread, this);
+            if (config->logCpu >= 0)
+                if (int const error = setThreadAffinity(logger->native_handle(), config->logCpu))
+                    PHOENIX_LOG_WARN(this->getHandler(), "Cannot pin logger thread to CPU", config->logCpu, std::strerror(error));
+        }
+
+        constexpr LogLevel minLevel = detail::getMinLogLevel<typename NodeBase::Traits>();
+        if (config->logLevel < minLevel)
+            PHOENIX_LOG_WARN(this->getHandler(), "Log level", config->logLevel, "is below the compiled minimum", minLevel);
     }
 
+    inline bool handle(tag::Logger::IsEnabled, LogLevel level) { return level >= this->getConfig()->logLevel; }
+
+    // Only copies raw argument bytes into the ring, all formatting happens on the logger thread
     template<typename... Args>
     inline void handle(tag::Logger::Log, LogLevel level, std::string_view filename, int line, Args&&... args)
     {
         if (level < this->getConfig()->logLevel)
             return;
 
-        handlerCache.str("");
-        handlerCache.clear();
-        ((handlerCache << " " << args), ...);
-
-        Entry entry{.line = line, .level = level, .message = handlerCache.str(), .filename = std::string{filename}};
-
-        pushEntry(entry);
+        pushRecord(level, filename, line, false, detail::toLoggable(args)...);
         if (level == LogLevel::FATAL)
             this->getHandler()->invoke(tag::Risk::Abort{});
     }
@@ -121,13 +200,7 @@ struct Logger : NodeBase
     template<typename Head, typename... Tail>
     inline void handle(tag::Logger::CSV, Head&& head, Tail&&... tail)
     {
-        handlerCache.str("");
-        handlerCache.clear();
-        handlerCache << head;
-        ((handlerCache << "," << tail), ...);
-
-        Entry entry{.message = handlerCache.str()};
-        pushEntry(entry);
+        pushRecord(LogLevel::INFO, {}, 0, true, detail::toLoggable(head), detail::toLoggable(tail)...);
     }
 
     template<typename... Args>
@@ -137,43 +210,259 @@ struct Logger : NodeBase
             handle(tag::Logger::Log{}, LogLevel::FATAL, filename, line, std::forward<Args>(args)...);
     }
 
+    // total entries dropped by the overflow policy so far
+    inline std::uint64_t handle(tag::Logger::Dropped) const { return dropped.load(std::memory_order_relaxed); }
+
     void handle(tag::Logger::Stop)
     {
+        if (auto const total = dropped.load(std::memory_order_relaxed))
+            PHOENIX_LOG_WARN(this->getHandler(), "[LOGGER] Dropped", total, "entries in total");
+
         shutdown();
-        if (!isSingleThreaded)
+        wakeLogger();
+        if (!isSingleThreaded && logger->joinable())
             logger->join();
+
+        if (isSingleThreaded)
+        {
+            drainSingleThreaded();
+            closeSinks();
+        }
     }
 
 private:
-    struct Entry
+    using Record = detail::LogRecord;
+
+    using Producer = detail::LogProducer;
+
+    struct ThreadProducer
     {
-        int line;
-        LogLevel level;
-        std::string message;
-        std::string filename;
+        std::uint64_t epoch = 0u;
+        Producer* producer = nullptr;
     };
 
-    void pushEntry(Entry& entry)
+    // Never waits for the logger thread, except for FATAL entries since the process aborts right after
+    template<typename... Args>
+    [[gnu::hot, gnu::always_inline]]
+    inline void pushRecord(LogLevel level, std::string_view filename, int line, bool isCSVRecord, Args const&... args)
+    {
+        Producer* producer = getProducer();
+        if (!producer) [[unlikely]]
+            return recordDrop(nullptr, level, filename, line);
+
+        std::size_t const size = detail::logRecordSize(args...);
+
+        // the loss marker goes first so the gap is reported where it happened
+        if (producer->gap.count && !pushLossMarker(*producer, level)) [[unlikely]]
+        {
+            if (level != LogLevel::FATAL)
+                return recordDrop(producer, level, filename, line);
+        }
+
+        std::byte* out = producer->reserve(level, size);
+        if (!out) [[unlikely]]
+        {
+            if (level != LogLevel::FATAL)
+                return recordDrop(producer, level, filename, line);
+
+            while (!(out = producer->reserve(level, size)))
+                _mm_pause();
+        }
+
+        writeRecord(*producer, out, level, filename, line, isCSVRecord, args...);
+
+        // relaxed so the hot path pays a plain load, a wake missed to reordering waits for the park timeout
+        if (parked.load(std::memory_order_relaxed)) [[unlikely]]
+            wakeLogger();
+
+        // only the starting thread drains, other threads' records are written on its next entry
+        if (isSingleThreaded && producer == producers[0].get()) [[unlikely]]
+            drainSingleThreaded();
+    }
+
+    // The calling thread's rings, a single thread local load once registered
+    [[gnu::hot, gnu::always_inline]]
+    inline Producer* getProducer()
+    {
+        if (threadProducer.epoch == epoch) [[likely]]
+            return threadProducer.producer;
+
+        return registerProducer();
+    }
+
+    // First entry from another thread, claims one of the preallocated producers (nullptr once all are taken)
+    [[gnu::cold, gnu::noinline]]
+    Producer* registerProducer()
+    {
+        if (!running.test())
+            return nullptr;
+
+        std::size_t const index = numProducers.fetch_add(1u, std::memory_order_acq_rel);
+        Producer* producer = index < MAX_PRODUCERS ? producers[index].get() : nullptr;
+        threadProducer = {.epoch = epoch, .producer = producer};
+        return producer;
+    }
+
+    [[gnu::cold, gnu::noinline]]
+    void wakeLogger()
+    {
+        if (parked.exchange(0u, std::memory_order_relaxed))
+            futexWakeOne(parked);
+    }
+
+    template<typename... Args>
+    [[gnu::hot, gnu::always_inline]]
+    inline void writeRecord(
+        Producer& producer,
+        std::byte* out,
+        LogLevel level,
+        std::string_view filename,
+        int line,
+        bool isCSVRecord,
+        Args const&... args)
+    {
+        // clang-format off
+        Record const record{
+            .decode = &detail::decodeLogArgs<Args...>,
+            .filename = filename.data(),
+            .filenameLength = static_cast<std::uint32_t>(filename.size()),
+            .line = line,
+            .timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count(),
+            .level = level,
+            .isCSV = isCSVRecord
+        };
+        // clang-format on
+
+        detail::encodeLogRecord(out, record, args...);
+        producer.commit();
+    }
+
+    [[gnu::cold, gnu::noinline]]
+    void recordDrop(Producer* producer, LogLevel level, std::string_view filename, int line)
+    {
+        dropped.fetch_add(1u, std::memory_order_relaxed);
+        if (!producer)
+            return;
+
+        auto& gap = producer->gap;
+        if (!gap.count)
+            gap = {.count = 0u, .level = level, .filename = filename, .line = line};
+
+        ++gap.count;
+    }
+
+    // Reported at the site of the first dropped entry, with the same headroom as the entry that follows it
+    [[gnu::cold, gnu::noinline]]
+    bool pushLossMarker(Producer& producer, LogLevel level)
     {
-        if (isSingleThreaded) [[unlikely]]
+        auto& gap = producer.gap;
+        auto const count = gap.count;
+        auto const firstLevel = gap.level;
+        std::string_view const marker = "[LOGGER] Dropped";
+        std::string_view const suffix = "entries, first was";
+
+        std::size_t const size = detail::logRecordSize(marker, count, suffix, firstLevel);
+        std::byte* out = producer.reserve(level, size);
+        if (!out)
+            return false;
+
+        writeRecord(producer, out, LogLevel::WARN, gap.filename, gap.line, false, marker, count, suffix, firstLevel);
+        gap.count = 0u;
+        return true;
+    }
+
+    // Oldest record across all producers, only the trading thread's rings are checked until another thread logs
+    [[gnu::hot, gnu::always_inline]]
+    inline ByteRing* nextRing()
+    {
+        std::size_t const count = std::min(numProducers.load(std::memory_order_acquire), MAX_PRODUCERS);
+        if (!count) [[unlikely]]
+            return nullptr;
+
+        ByteRing* ring = producers[0]->nextRing();
+        if (count == 1u) [[likely]]
+            return ring;
+
+        std::int64_t oldest = ring ? detail::frontTimestamp(*ring) : std::numeric_limits<std::int64_t>::max();
+        for (std::size_t i = 1u; i < count; ++i)
         {
-            std::string const formatted = formatEntry(entry);
-            writeEntry(formatted);
-            if (this->getConfig()->printLogs)
-                std::cout << formatted << std::endl;
+            ByteRing* other = producers[i]->nextRing();
+            if (!other)
+                continue;
 
-            logFile->flush();
-            if (entry.level == LogLevel::FATAL)
+            std::int64_t const timestamp = detail::frontTimestamp(*other);
+            if (timestamp < oldest)
             {
-                running.clear();
-                logFile->close();
+                ring = other;
+                oldest = timestamp;
             }
         }
-        else [[likely]]
+
+        return ring;
+    }
+
+    bool isEmpty()
+    {
+        std::size_t const count = std::min(numProducers.load(std::memory_order_acquire), MAX_PRODUCERS);
+        for (std::size_t i = 0u; i < count; ++i)
+            if (!producers[i]->empty())
+                return false;
+
+        return true;
+    }
+
+    // the record timestamps are used as the clock so nothing else is read per entry
+    void drainSingleThreaded()
+    {
+        while (auto* ring = nextRing())
         {
-            while (!entries.push(entry))
-                _mm_pause();
+            std::int64_t const timestamp = processRecord(*ring);
+            if (!timestamp)
+                return;
+
+            if (timestamp - lastFlush >= FLUSH_INTERVAL_NS) [[unlikely]]
+            {
+                flushSinks();
+                lastFlush = timestamp;
+            }
+        }
+    }
+
+    // returns the record timestamp, or 0 after a FATAL record which closes the sinks
+    [[gnu::hot]]
+    std::int64_t processRecord(ByteRing& ring)
+    {
+        auto const* payload = ring.front();
+        Record record;
+        std::memcpy(&record, payload, sizeof(Record));
+
+        writeEntry(logFile, fileStream, record, payload + sizeof(Record));
+        if (console.isOpen()) [[unlikely]]
+            writeEntry(console, consoleStream, record, payload + sizeof(Record));
+
+        ring.pop();
+
+        if (record.level == LogLevel::FATAL) [[unlikely]]
+        {
+            running.clear();
+            closeSinks();
+            return 0;
         }
+
+        return record.timestamp;
+    }
+
+    void flushSinks()
+    {
+        logFile.flush();
+        console.flush();
+    }
+
+    void closeSinks()
+    {
+        logFile.close();
+        console.close();
     }
 
     void shutdown()
@@ -187,98 +476,144 @@ private:
 
     void loggerThread()
     {
-        auto const flushInterval = std::chrono::milliseconds(500);
-        auto lastFlush = std::chrono::system_clock::now();
-        Entry entry;
-
-        auto* config = this->getConfig();
-        auto const processEntry = [&entry, config, this]
+        // the sinks only write when their buffer is full, or here on an interval
+        std::size_t processed = 0u;
+        auto const processRecords = [this, &processed]
         {
-            std::string const formatted = formatEntry(entry);
-            writeEntry(formatted);
-
-            if (config->printLogs)
-                std::cout << formatted << std::endl;
-
-            if (entry.level == LogLevel::FATAL)
+            processed = 0u;
+            while (auto* ring = nextRing())
             {
-                running.clear();
-                logFile->flush();
-                logFile->close();
-                return false;
+                if (!processRecord(*ring))
+                    return false;
+
+                ++processed;
             }
 
             return true;
         };
 
+        std::size_t idleRounds = 0u;
         while (running.test())
         {
-            while (entries.pop(entry))
-                if (!processEntry())
-                    return;
+            if (!processRecords())
+                return;
+
+            if (processed)
+                idleRounds = 0u;
+            else
+                idleWait(idleRounds++);
 
-            auto now = std::chrono::system_clock::now();
-            if (now - lastFlush >= flushInterval)
+            auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+
+            if (now - lastFlush >= FLUSH_INTERVAL_NS)
             {
-                logFile->flush();
+                flushSinks();
                 lastFlush = now;
             }
+        }
 
+        if (!processRecords())
+            return;
+
+        closeSinks();
+    }
+
+    // Backs off gradually so a busy logger never sleeps, and a quiet one gives its core back
+    void idleWait(std::size_t rounds)
+    {
+        switch (idle)
+        {
+        case LogIdle::SPIN:
+            _mm_pause();
+            return;
+        case LogIdle::YIELD:
             std::this_thread::yield();
+            return;
+        case LogIdle::BACKOFF:
+            break;
         }
 
-        while (entries.pop(entry))
-            if (!processEntry())
-                return;
+        if (rounds < IDLE_SPIN_ROUNDS)
+            return;
 
-        logFile->flush();
-        logFile->close();
-    }
+        if (rounds < IDLE_PAUSE_ROUNDS)
+        {
+            _mm_pause();
+            return;
+        }
 
-    void writeEntry(std::string_view formatted) { *logFile << formatted << std::endl; }
+        if (rounds < IDLE_YIELD_ROUNDS)
+        {
+            std::this_thread::yield();
+            return;
+        }
 
-    std::string formatEntry(Entry const& entry)
-    {
-        loggerCache.str("");
-        loggerCache.clear();
+        // the store has to be visible before the rings are checked again, or a producer could miss it
+        parked.store(1u, std::memory_order_seq_cst);
+        if (running.test() && isEmpty())
+            futexWait(parked, 1u, PARK_TIMEOUT_NS);
 
-        auto now = std::chrono::system_clock::now();
-        auto timeT = std::chrono::system_clock::to_time_t(now);
+        parked.store(0u, std::memory_order_relaxed);
+    }
 
-        if (isCSV)
-            loggerCache << entry.message;
+    // formats straight into the sink buffer, only the arguments go through the ostream
+    [[gnu::hot]]
+    void writeEntry(LogSink& sink, std::ostream& os, Record const& record, std::byte const* args)
+    {
+        if (record.isCSV)
+            record.decode(args, os, true);
         else
         {
-            // clang-format off
-            loggerCache
-                << std::put_time(std::gmtime(&timeT), "%Y-%m-%dT%H:%M:%SZ")
-                << " [" 
-                << logLevelString(entry.level)
-                << "] "
-                << entry.filename
-                << ":" 
-                << entry.line
-                << " -"
-                << entry.message
-            ;
-            // clang-format on
+            sink.appendTimestamp(record.timestamp);
+            sink.append(" [");
+            sink.append(logLevelString(record.level));
+            sink.append("] ");
+            sink.append({record.filename, record.filenameLength});
+            sink.append(':');
+            os << record.line;
+            sink.append(" -");
+
+            record.decode(args, os, false);
         }
 
-        return loggerCache.str();
+        sink.append('\n');
     }
 
     static std::size_t LOGGERS;
-    static constexpr std::size_t QUEUE_SIZE = 8192u;
+    static std::uint64_t EPOCHS;
+    static inline thread_local ThreadProducer threadProducer;
+
+    // the trading thread always has the first producer, other threads get smaller rings
+    static constexpr std::size_t MAX_PRODUCERS = 8u;
+    static constexpr std::size_t HELPER_RING_CAPACITY = 1u << 16u;
+    static constexpr std::size_t RING_CAPACITY = 1u << 20u;
+    static constexpr std::int64_t FLUSH_INTERVAL_NS = 500'000'000;
+    static constexpr long PARK_TIMEOUT_NS = 1'000'000;
+    static constexpr std::size_t IDLE_SPIN_ROUNDS = 64u;
+    static constexpr std::size_t IDLE_PAUSE_ROUNDS = IDLE_SPIN_ROUNDS + 1024u;
+    static constexpr std::size_t IDLE_YIELD_ROUNDS = IDLE_PAUSE_ROUNDS + 64u;
 
     std::string logPath;
     std::optional<std::thread> logger;
-    std::optional<std::ofstream> logFile;
+
+    LogSink logFile;
+    LogSink console{1u << 16u};
+    std::ostream fileStream{&logFile};
+    std::ostream consoleStream{&console};
+    std::int64_t lastFlush = 0;
 
     std::atomic_flag running = ATOMIC_FLAG_INIT;
-    boost::lockfree::spsc_queue<Entry> entries{QUEUE_SIZE};
 
-    std::stringstream handlerCache;
-    std::stringstream loggerCache;
+    std::array<std::unique_ptr<Producer>, MAX_PRODUCERS> producers;
+    std::atomic<std::size_t> numProducers{0u}; // claimed, can go past MAX_PRODUCERS
+    std::uint64_t epoch = 0u;
+    std::atomic<std::uint64_t> dropped{0u};
+
+    // futex word, non-zero while the logger thread is parked
+    LogIdle idle = LogIdle::BACKOFF;
+    alignas(64) std::atomic<std::uint32_t> parked{0u};
 
     bool isCSV = false;
     bool isSingleThreaded = false;
@@ -287,4 +622,7 @@ private:
 template<typename NodeBase>
 std::size_t Logger<NodeBase>::LOGGERS = 0u;
 
+template<typename NodeBase>
+std::uint64_t Logger<NodeBase>::EPOCHS = 0u;
+
 } // namespace phoenix
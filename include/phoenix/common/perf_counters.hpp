@@ -0,0 +1,176 @@
+#pragma once
+
+#include "phoenix/common/logger.hpp"
+#include "phoenix/graph/router_handler.hpp"
+#include "phoenix/tags.hpp"
+#include "phoenix/tools/perf_counter_group.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+namespace phoenix {
+
+// Opt-in hardware counter instrumentation of named regions (enabled by config->perfCounters)
+// Counters are opened for the thread constructing the graph, which should be the trading thread
+template<typename NodeBase>
+struct PerfCounters : NodeBase
+{
+    using Router = NodeBase::Router;
+    using Sample = PerfCounterGroup::Sample;
+
+    PerfCounters(auto const& config, auto& handler)
+        : NodeBase{config, handler}
+    {
+        if (config.perfCounters)
+            openError = counters.open();
+    }
+
+    struct Region
+    {
+        std::string_view name;
+        std::uint64_t samples = 0u;
+        Sample totals{};
+        std::uint64_t minCycles = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t maxCycles = 0u;
+    };
+
+    struct Guard
+    {
+        Guard() = default;
+        Guard(PerfCounters* node, Region* region)
+            : node{node}
+            , region{region}
+        {
+            node->counters.read(start);
+        }
+
+        Guard(Guard&& other)
+            : node{other.node}
+            , region{other.region}
+            , start{other.start}
+        {
+            other.node = nullptr;
+        }
+
+        Guard(Guard const&) = delete;
+        Guard& operator=(Guard const&) = delete;
+        Guard& operator=(Guard&&) = delete;
+
+        ~Guard()
+        {
+            if (node) [[unlikely]]
+            {
+                Sample end;
+                node->counters.read(end);
+                node->accumulate(*region, start, end);
+            }
+        }
+
+        PerfCounters* node = nullptr;
+        Region* region = nullptr;
+        Sample start;
+    };
+
+    [[gnu::hot, gnu::always_inline]]
+    inline Guard handle(tag::PerfCounters::Guard, std::string_view name)
+    {
+        if (!counters.isOpen()) [[likely]]
+            return Guard{};
+
+        auto* region = findRegion(name);
+        return region ? Guard{this, region} : Guard{};
+    }
+
+    void handle(tag::PerfCounters::Report)
+    {
+        auto* handler = this->getHandler();
+        if (!this->getConfig()->perfCounters)
+            return;
+
+        if (!counters.isOpen())
+        {
+            PHOENIX_LOG_WARN(handler, "[PERF] Counters unavailable:", std::strerror(openError));
+            return;
+        }
+
+        if (!counters.isUserReadable())
+            PHOENIX_LOG_WARN(handler, "[PERF] rdpmc not permitted, counters were read with syscalls");
+
+        for (std::size_t i = 0u; i < numRegions; ++i)
+        {
+            auto const& region = regions[i];
+            if (!region.samples)
+                continue;
+
+            double const n = static_cast<double>(region.samples);
+            auto const perSample = [&](std::size_t counter) { return region.totals[counter] / n; };
+            double const cycles = region.totals[PerfCounterGroup::CYCLES];
+            auto const* names = PerfCounterGroup::COUNTER_NAMES;
+
+            PHOENIX_LOG_INFO(
+                handler,
+                "[PERF]",
+                region.name,
+                "samples",
+                region.samples,
+                names[PerfCounterGroup::CYCLES],
+                perSample(PerfCounterGroup::CYCLES),
+                "min",
+                region.minCycles,
+                "max",
+                region.maxCycles,
+                names[PerfCounterGroup::INSTRUCTIONS],
+                perSample(PerfCounterGroup::INSTRUCTIONS),
+                "ipc",
+                cycles ? region.totals[PerfCounterGroup::INSTRUCTIONS] / cycles : 0.0,
+                names[PerfCounterGroup::L1D_MISSES],
+                perSample(PerfCounterGroup::L1D_MISSES),
+                names[PerfCounterGroup::LLC_MISSES],
+                perSample(PerfCounterGroup::LLC_MISSES),
+                names[PerfCounterGroup::BRANCH_MISSES],
+                perSample(PerfCounterGroup::BRANCH_MISSES));
+        }
+    }
+
+private:
+    // names are expected to be literals, so pointer equality is checked first
+    [[gnu::hot, gnu::always_inline]]
+    inline Region* findRegion(std::string_view name)
+    {
+        for (std::size_t i = 0u; i < numRegions; ++i)
+            if (regions[i].name.data() == name.data() || regions[i].name == name)
+                return &regions[i];
+
+        if (numRegions == MAX_REGIONS) [[unlikely]]
+            return nullptr;
+
+        auto& region = regions[numRegions++];
+        region.name = name;
+        return &region;
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void accumulate(Region& region, Sample const& start, Sample const& end)
+    {
+        for (std::size_t i = 0u; i < PerfCounterGroup::NUM_COUNTERS; ++i)
+            region.totals[i] += end[i] - start[i];
+
+        std::uint64_t const cycles = end[PerfCounterGroup::CYCLES] - start[PerfCounterGroup::CYCLES];
+        region.minCycles = std::min(region.minCycles, cycles);
+        region.maxCycles = std::max(region.maxCycles, cycles);
+        ++region.samples;
+    }
+
+    static constexpr std::size_t MAX_REGIONS = 16u;
+
+    PerfCounterGroup counters;
+    int openError = 0;
+
+    std::array<Region, MAX_REGIONS> regions;
+    std::size_t numRegions = 0u;
+};
+
+} // namespace phoenix
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "phoenix/common/logger.hpp"
+#include "phoenix/data/fix.hpp"
+#include "phoenix/data/order_table.hpp"
+#include "phoenix/data/orders.hpp"
+#include "phoenix/tags.hpp"
+#include "phoenix/tools/fixed_string.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace phoenix {
+
+struct Submitted
+{
+    bool isAccepted = false;  // sent or queued
+    ClOrdId superseded = 0u;  // a queued order of the same key that now never goes out, 0 without one
+};
+
+// Outbound messages against the credits of the TCPSocket, by priority instead of spinning until the throttle allows them
+// Submit sends at once when nothing of the same or a higher priority waits on its session, otherwise queues a copy of the order
+// Tick, once per loop of the stream, releases the queues as credits come back, and a newer quote supersedes a queued one of its key
+// Sessions have credits of their own, one out of them keeps its orders queued while the others go on with theirs
+template<typename NodeBase>
+struct Scheduler : NodeBase
+{
+    using NodeBase::NodeBase;
+
+    using Traits = NodeBase::Traits;
+    using Order = SingleOrder<Traits>;
+
+    // per priority, orders past it are refused so the caller can drop them
+    static constexpr std::size_t QUEUE_CAPACITY = 32u;
+
+    // key 0 never supersedes anything
+    [[gnu::hot, gnu::always_inline]]
+    inline Submitted handle(tag::Scheduler::Submit, Priority priority, OrderAction action, Order const& order, std::uint64_t key = 0u)
+    {
+        auto* handler = this->getHandler();
+        auto& queue = queues[static_cast<std::size_t>(priority)];
+
+        if (key)
+        {
+            if (auto* queued = queue.find(key))
+            {
+                ClOrdId const superseded = queued->order.clOrdId;
+                --getQueuedOf(queued->order.session, priority);
+                *queued = {action, order, key};
+                ++getQueuedOf(order.session, priority);
+                return {true, superseded};
+            }
+        }
+
+        if (!hasQueued(priority, order.session) && handler->retrieve(tag::Stream::Release{}, priority, action, order)) [[likely]]
+            return {true};
+
+        if (!queue.push({action, order, key})) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "Outbound queue full, order refused", order.symbol);
+            return {};
+        }
+
+        ++getQueuedOf(order.session, priority);
+        ++numQueued;
+        return {true};
+    }
+
+    // sent on the next tick with the credits for it, after every order
+    // the reply to a TestRequest goes out the same way with its TestReqID (112), one heartbeat answers both
+    void handle(tag::Scheduler::Heartbeat, std::string_view testReqId = {})
+    {
+        isHeartbeatDue = true;
+        if (!testReqId.empty())
+            dueTestReqId = testReqId;
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void handle(tag::Scheduler::Tick)
+    {
+        if (!numQueued && !isHeartbeatDue) [[likely]]
+            return;
+
+        // sessions that refused an order this tick, what they have left waits for the next one
+        auto* handler = this->getHandler();
+        std::uint32_t blocked = 0u;
+        for (std::size_t i = 0u; i < NUM_PRIORITIES; ++i)
+        {
+            auto const priority = static_cast<Priority>(i);
+            queues[i].releaseIf(
+                [&](Entry const& entry)
+                {
+                    std::uint32_t const session = 1u << entry.order.session;
+                    if (blocked & session)
+                        return false;
+
+                    if (!handler->retrieve(tag::Stream::Release{}, priority, entry.action, entry.order))
+                    {
+                        blocked |= session;
+                        return false;
+                    }
+
+                    --getQueuedOf(entry.order.session, priority);
+                    --numQueued;
+                    return true;
+                });
+        }
+
+        // the heartbeat is of the main session, after every order of it
+        if (isHeartbeatDue && !(blocked & 1u) && handler->retrieve(tag::Stream::SendHeartbeat{}, dueTestReqId.view()))
+        {
+            isHeartbeatDue = false;
+            dueTestReqId.clear();
+        }
+    }
+
+    // orders and heartbeats waiting for credits
+    std::size_t handle(tag::Scheduler::GetQueued) const { return numQueued + isHeartbeatDue; }
+
+    // anything of the session waits at the priority or above it, what a batch of the priority on it has to go out after
+    [[gnu::hot, gnu::always_inline]]
+    inline bool handle(tag::Scheduler::HasQueued, Priority priority, std::size_t session) const
+    {
+        return hasQueued(priority, session);
+    }
+
+    // an order of the key still waits, a later Submit of the key supersedes it before it goes out
+    [[gnu::hot, gnu::always_inline]]
+    inline bool handle(tag::Scheduler::IsQueued, Priority priority, std::uint64_t key) const
+    {
+        return key && queues[static_cast<std::size_t>(priority)].contains(key);
+    }
+
+private:
+    struct Entry
+    {
+        OrderAction action;
+        Order order;
+        std::uint64_t key;
+    };
+
+    // FIFO ring, a superseded entry keeps its place, and so does every entry Tick leaves behind
+    struct Queue
+    {
+        bool push(Entry const& entry)
+        {
+            if (size == QUEUE_CAPACITY)
+                return false;
+
+            entries[(head + size++) % QUEUE_CAPACITY] = entry;
+            return true;
+        }
+
+        Entry* find(std::uint64_t key)
+        {
+            for (std::size_t i = 0u; i < size; ++i)
+            {
+                auto& entry = entries[(head + i) % QUEUE_CAPACITY];
+                if (entry.key == key)
+                    return &entry;
+            }
+
+            return nullptr;
+        }
+
+        bool contains(std::uint64_t key) const
+        {
+            for (std::size_t i = 0u; i < size; ++i)
+            {
+                if (entries[(head + i) % QUEUE_CAPACITY].key == key)
+                    return true;
+            }
+
+            return false;
+        }
+
+        // drops the entries release takes, in order, and closes the gaps they leave
+        template<typename Release>
+        void releaseIf(Release&& release)
+        {
+            std::size_t kept = 0u;
+            for (std::size_t i = 0u; i < size; ++i)
+            {
+                auto& entry = entries[(head + i) % QUEUE_CAPACITY];
+                if (release(entry))
+                    continue;
+
+                if (kept != i)
+                    entries[(head + kept) % QUEUE_CAPACITY] = entry;
+
+                ++kept;
+            }
+
+            size = kept;
+        }
+
+        std::array<Entry, QUEUE_CAPACITY> entries{};
+        std::size_t head = 0u;
+        std::size_t size = 0u;
+    };
+
+    bool hasQueued(Priority priority, std::size_t session) const
+    {
+        for (std::size_t i = 0u; i <= static_cast<std::size_t>(priority); ++i)
+            if (queuedOf[session][i])
+                return true;
+
+        return false;
+    }
+
+    std::size_t& getQueuedOf(std::size_t session, Priority priority) { return queuedOf[session][static_cast<std::size_t>(priority)]; }
+
+    std::array<Queue, NUM_PRIORITIES> queues;
+    std::array<std::array<std::size_t, NUM_PRIORITIES>, MAX_SESSIONS> queuedOf{}; // entries of each session in each queue
+    std::size_t numQueued = 0u;
+    bool isHeartbeatDue = false;
+    FixedString<TEST_REQ_ID_CAPACITY> dueTestReqId;
+};
+
+} // namespace phoenix
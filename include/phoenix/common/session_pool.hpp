@@ -0,0 +1,287 @@
+#pragma once
+
+#include "phoenix/common/logger.hpp"
+#include "phoenix/data/fix.hpp"
+#include "phoenix/data/orders.hpp"
+#include "phoenix/tags.hpp"
+#include "phoenix/tools/fix_session.hpp"
+#include "phoenix/tools/fixed_string.hpp"
+#include "phoenix/tools/tracepoints.hpp"
+
+#include <boost/asio.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <immintrin.h>
+
+namespace {
+namespace io = ::boost::asio;
+} // namespace
+
+namespace phoenix {
+
+// Order sessions of subaccounts next to the main one of the Stream, each with its own sequence numbers and credits
+// An order goes out on the session it names, session 0 is the main one and never reaches the pool
+// Sessions only trade, Receive polls them in turn without blocking and hands out their execution reports and cancel rejects
+template<typename NodeBase>
+struct SessionPool : NodeBase
+{
+    using NodeBase::NodeBase;
+
+    using Traits = NodeBase::Traits;
+    using Order = SingleOrder<Traits>;
+
+    void handle(tag::SessionPool::Start)
+    {
+        auto* handler = this->getHandler();
+        auto* config = this->getConfig();
+        auto const& usernames = config->subaccountUsernames;
+        auto const& secrets = config->subaccountSecrets;
+        PHOENIX_LOG_VERIFY(
+            handler, (usernames.size() == secrets.size()), "Subaccounts without a secret each", usernames.size(), secrets.size());
+        PHOENIX_LOG_VERIFY(handler, (usernames.size() < MAX_SESSIONS), "Too many subaccounts", usernames.size());
+
+        for (std::size_t i = 0u; i < usernames.size(); ++i)
+        {
+            // a session of its own needs a name of its own
+            auto& session = *sessions.emplace_back(std::make_unique<Session>(ioContext, config->client + "-" + std::to_string(i + 1u)));
+            session.username = usernames[i];
+            connect(session, config->host, config->port, config->colo);
+            login(session, secrets[i]);
+        }
+    }
+
+    void handle(tag::SessionPool::Stop)
+    {
+        auto* handler = this->getHandler();
+        for (auto& session : sessions)
+        {
+            forceSend(*session, session->fixBuilder.logout(session->nextSeqNum++));
+
+            boost::system::error_code error;
+            session->connection.close(error);
+            if (error)
+                PHOENIX_LOG_ERROR(handler, "Error closing subaccount socket", session->username, error.message());
+        }
+    }
+
+    // sessions to shard orders across, the main one included
+    [[gnu::hot, gnu::always_inline]]
+    inline std::size_t handle(tag::SessionPool::GetSize) const { return sessions.size() + 1u; }
+
+    // false without the credits of the session for it
+    [[gnu::hot, gnu::always_inline]]
+    inline bool handle(tag::SessionPool::Send, OrderAction action, Order const& order)
+    {
+        auto& session = *sessions[order.session - 1u];
+        if (!checkThrottle(session, 1u))
+            return false;
+
+        sendUnthrottled(session, encode(session, action, order));
+        return true;
+    }
+
+    // every request or none, all of the session of the first one
+    inline bool handle(tag::SessionPool::SendBatch, std::span<OrderRequest<Traits> const> requests)
+    {
+        auto& session = *sessions[requests.front().order->session - 1u];
+        if (!checkThrottle(session, requests.size()))
+            return false;
+
+        batch.clear();
+        for (auto const& [action, order] : requests)
+            batch.add(encode(session, action, *order));
+
+        sendUnthrottled(session, batch.view());
+        return true;
+    }
+
+    // sent by each session on a later Receive with the credits for it
+    void handle(tag::SessionPool::Heartbeat)
+    {
+        for (auto& session : sessions)
+        {
+            session->isHeartbeatDue = true;
+            PHOENIX_LOG_INFO(
+                this->getHandler(), "[SESSION]", session->username, "sent", session->numSent, "reports", session->numReports);
+        }
+    }
+
+    // the next report of any session, the session after the last one served first
+    // the returned view stays valid until the next Receive
+    [[gnu::hot, gnu::always_inline]]
+    inline std::optional<std::string_view> handle(tag::SessionPool::Receive)
+    {
+        for (std::size_t n = 0u; n < sessions.size(); ++n)
+        {
+            std::size_t const i = (nextSession + n) % sessions.size();
+            auto& session = *sessions[i];
+            if (session.isHeartbeatDue && checkThrottle(session, 1u))
+            {
+                auto const& testReqId = session.dueTestReqId;
+                sendUnthrottled(
+                    session,
+                    testReqId.empty() ? session.fixBuilder.heartbeat(session.nextSeqNum++)
+                                      : session.fixBuilder.heartbeat(session.nextSeqNum++, testReqId.view()));
+                session.isHeartbeatDue = false;
+                session.dueTestReqId.clear();
+            }
+
+            while (auto msg = receive(session))
+            {
+                if (isAdmin(session, *msg))
+                    continue;
+
+                ++session.numReports;
+                nextSession = i + 1u;
+                return msg;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+private:
+    // the connection and credits of a subaccount, and the sequence numbers the Stream keeps for the main one
+    struct Session
+    {
+        Session(io::io_context& ioContext, std::string const& client)
+            : connection{ioContext}
+            , fixBuilder{client}
+        {}
+
+        std::string username;
+        FIXSession connection;
+        FIXMessageBuilder fixBuilder;
+        std::size_t nextSeqNum = 1u;
+        bool isHeartbeatDue = false;
+        FixedString<TEST_REQ_ID_CAPACITY> dueTestReqId; // of a TestRequest the due heartbeat answers
+        std::uint64_t numSent = 0u;
+        std::uint64_t numReports = 0u;
+    };
+
+    void connect(Session& session, std::string const& host, std::string const& portStr, bool isColo)
+    {
+        try
+        {
+            session.connection.connect(ioContext, host, portStr, isColo);
+            PHOENIX_LOG_INFO(this->getHandler(), "Connected subaccount", session.username);
+        }
+        catch (std::exception const& e)
+        {
+            PHOENIX_LOG_FATAL(this->getHandler(), "Subaccount connection error", session.username, e.what());
+        }
+    }
+
+    void login(Session& session, std::string const& secret)
+    {
+        auto* handler = this->getHandler();
+        forceSend(session, session.fixBuilder.login(session.nextSeqNum++, session.username, secret, 120));
+
+        auto msg = receive(session, true);
+        while (!msg)
+            msg = receive(session, true);
+
+        FIXReader reader{*msg};
+        PHOENIX_LOG_VERIFY(
+            handler, reader.isMessageType("A"), "Subaccount login unsuccessful", session.username, reader.getMessageType());
+        PHOENIX_LOG_INFO(handler, "Subaccount login successful", session.username);
+    }
+
+    // under the next sequence number of the session
+    [[gnu::hot, gnu::always_inline]]
+    inline std::string_view encode(Session& session, OrderAction action, Order const& order)
+    {
+        auto& fixBuilder = session.fixBuilder;
+        std::size_t const seqNum = session.nextSeqNum++;
+        ++session.numSent;
+
+        switch (action)
+        {
+        case OrderAction::NEW: return fixBuilder.newOrderSingle(seqNum, order.symbol, order);
+        case OrderAction::REPLACE: return fixBuilder.orderCancelReplaceRequest(seqNum, order.symbol, order);
+        case OrderAction::CANCEL: return fixBuilder.orderCancelRequest(seqNum, order.symbol, order.orderId, order.clOrdId);
+        }
+
+        return {};
+    }
+
+    // heartbeats and test requests stay with the session, a test request is answered by its next heartbeat,
+    // anything else but a report is only logged
+    [[gnu::hot, gnu::always_inline]]
+    inline bool isAdmin(Session& session, std::string_view msg)
+    {
+        reader.init(msg);
+        auto const msgType = reader.getMessageType();
+        PHOENIX_TRACE(parse, msg.size());
+
+        if (msgType == "8" || msgType == "9") [[likely]]
+            return false;
+
+        // heartbeat
+        if (msgType == "0")
+            return true;
+
+        // test request
+        if (msgType == "1")
+        {
+            session.isHeartbeatDue = true;
+            session.dueTestReqId = reader.getStringView(112);
+            PHOENIX_LOG_INFO(this->getHandler(), "Received TestRequest on subaccount, Heartbeat due", session.username);
+            return true;
+        }
+
+        PHOENIX_LOG_WARN(this->getHandler(), "Unhandled subaccount message", session.username, msgType, reader.getStringView(58));
+        return true;
+    }
+
+    // never blocks unless asked to, a partial message stays in the buffer
+    [[gnu::hot, gnu::always_inline]]
+    inline std::optional<std::string_view> receive(Session& session, bool isBlocking = false)
+    {
+        auto* handler = this->getHandler();
+        boost::system::error_code error;
+        auto msg = session.connection.receive(error, isBlocking);
+        PHOENIX_LOG_VERIFY(handler, (!error), "Error while receiving on subaccount", session.username, error.message());
+
+        if (msg)
+            handler->invoke(tag::FlightRecorder::Inbound{}, *msg);
+
+        return msg;
+    }
+
+    inline bool checkThrottle(Session& session, std::size_t numMessages) { return session.connection.checkThrottle(numMessages); }
+
+    inline void forceSend(Session& session, std::string_view msg)
+    {
+        while (!checkThrottle(session, 1u))
+            _mm_pause();
+
+        sendUnthrottled(session, msg);
+    }
+
+    inline void sendUnthrottled(Session& session, std::string_view msg)
+    {
+        this->getHandler()->invoke(tag::FlightRecorder::Outbound{}, msg);
+
+        boost::system::error_code error;
+        session.connection.sendUnthrottled(msg, error);
+        PHOENIX_LOG_VERIFY(this->getHandler(), (!error), "Error while sending on subaccount", session.username, error.message());
+    }
+
+    io::io_context ioContext;
+    std::vector<std::unique_ptr<Session>> sessions;
+    std::size_t nextSession = 0u;
+    FIXBatch batch;
+    FIXReaderFast reader;
+};
+
+} // namespace phoenix
@@ -4,12 +4,11 @@
 #include "phoenix/common/profiler.hpp"
 #include "phoenix/data/fix.hpp"
 #include "phoenix/data/orders.hpp"
-#include "phoenix/tools/fix_circular_buffer.hpp"
+#include "phoenix/tools/fix_session.hpp"
 #include "phoenix/tags.hpp"
 
 #include <boost/asio.hpp>
 
-#include <chrono>
 #include <concepts>
 #include <exception>
 #include <optional>
@@ -17,7 +16,6 @@
 #include <string_view>
 
 #include <immintrin.h>
-#include <linux/socket.h>
 
 namespace {
 namespace io = ::boost::asio;
@@ -38,7 +36,7 @@ struct TCPSocket : NodeBase
 
         handler->invoke(tag::TCPSocket::ForceSend{}, logoutMsg);
         boost::system::error_code error;
-        socket.close(error);
+        session.close(error);
 
         if (error)
             PHOENIX_LOG_ERROR(handler, "Error closing socket", error.message());
@@ -48,27 +46,7 @@ struct TCPSocket : NodeBase
     {
         try
         {
-            if (isColo)
-            {
-                int port = std::atoi(portStr.c_str());
-                io::ip::tcp::endpoint endpoint(io::ip::address::from_string(host), port);
-                socket.connect(endpoint);
-            }
-            else
-            {
-                io::ip::tcp::resolver resolver{ioContext};
-                auto endpoints = resolver.resolve(host, portStr);
-                io::connect(socket, endpoints);
-            }
-            
-            socket.set_option(io::ip::tcp::no_delay(true));
-            socket.set_option(boost::asio::socket_base::receive_buffer_size(8 * 1024));
-            socket.set_option(boost::asio::socket_base::send_buffer_size(8 * 1024));
-
-            setsockopt(socket.native_handle(), SOL_SOCKET, SO_PRIORITY, &SOCKET_PRIORITY, sizeof(SOCKET_PRIORITY));
-            setsockopt(socket.native_handle(), IPPROTO_TCP, TCP_QUICKACK, &SOCKET_ENABLE_FLAG, sizeof(SOCKET_ENABLE_FLAG));
-            setsockopt(socket.native_handle(), SOL_SOCKET, SO_BUSY_POLL, &SOCKET_POLL_MICROSECONDS, sizeof(SOCKET_POLL_MICROSECONDS));
- 
+            session.connect(ioContext, host, portStr, isColo);
             PHOENIX_LOG_INFO(this->getHandler(), "Connected successfully");
         }
         catch (std::exception const& e)
@@ -120,59 +98,41 @@ struct TCPSocket : NodeBase
 
     inline std::optional<std::string_view> handle(tag::TCPSocket::Receive)
     {
-        auto leftoverMsg = circularBuffer.getMsg(0u);
-        if (leftoverMsg)
-            return leftoverMsg;
-
+        auto* handler = this->getHandler();
         boost::system::error_code error;
-        auto bytesRead = socket.read_some(circularBuffer.getAsioBuffer(), error);
-        PHOENIX_LOG_VERIFY(this->getHandler(), (!error), "Error while receiving message", error.message());
-        return circularBuffer.getMsg(bytesRead);
+        auto msg = session.receive(error);
+        PHOENIX_LOG_VERIFY(handler, (!error), "Error while receiving message", error.message());
+
+        if (msg)
+            handler->invoke(tag::FlightRecorder::Inbound{}, *msg);
+
+        return msg;
     };
 
-private:
-    inline bool checkThrottle(std::size_t numMessages)
+    // bytes Receive can take without blocking, a partial message left in the buffer doesn't count
+    [[gnu::hot, gnu::always_inline]]
+    inline std::size_t handle(tag::TCPSocket::Available)
     {
-        auto nextAllowed = lastSent + THROTTLE_INTERVAL;
-        auto now = std::chrono::steady_clock::now();
-
-        if (msgCountInterval <= MESSAGES_IN_INTERVAL - numMessages)
-        {
-            msgCountInterval += numMessages;
-            return true;
-        }
-        else if (now >= nextAllowed)
-        {
-            lastSent = now;
-            msgCountInterval = numMessages;
-            return true;
-        }
-        else
-            return false;
+        boost::system::error_code error;
+        std::size_t const pending = session.available(error);
+        PHOENIX_LOG_VERIFY(this->getHandler(), (!error), "Error while polling socket", error.message());
+        return pending;
     }
 
+private:
+    inline bool checkThrottle(std::size_t numMessages) { return session.checkThrottle(numMessages); }
+
     inline void sendUnthrottled(std::string_view msg)
     {
+        this->getHandler()->invoke(tag::FlightRecorder::Outbound{}, msg);
+
         boost::system::error_code error;
-        io::write(socket, io::buffer(msg), error);
+        session.sendUnthrottled(msg, error);
         PHOENIX_LOG_VERIFY(this->getHandler(), (!error), "Error while sending message", msg, error.message());
     }
 
-    // setup
-    static constexpr int SOCKET_PRIORITY{6};
-    static constexpr int SOCKET_ENABLE_FLAG{1};
-    static constexpr int SOCKET_POLL_MICROSECONDS{10000};
-
-    // socket
     io::io_context ioContext;
-    io::ip::tcp::socket socket{ioContext};
-    FIXCircularBuffer circularBuffer;
-    
-    // throttling
-    static constexpr std::chrono::seconds THROTTLE_INTERVAL{1u};
-    static constexpr std::size_t MESSAGES_IN_INTERVAL{5u};
-    std::chrono::steady_clock::time_point lastSent = std::chrono::steady_clock::now();
-    std::uint64_t msgCountInterval = 0u;
+    FIXSession session{ioContext};
 };
 
 }
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace phoenix {
+
+// One conversion of a cycle, selling the base at the bid or buying it at the ask
+struct CycleLeg
+{
+    std::uint32_t instrument;
+    bool isBuy;
+};
+
+// Closed path through the currency graph, starting and ending in the currency of the first leg
+struct Cycle
+{
+    static constexpr std::size_t MAX_LEGS = 4u;
+
+    std::array<CycleLeg, MAX_LEGS> legs{};
+    std::uint32_t numLegs = 0u;
+};
+
+// Every 3 and 4 leg arbitrage cycle through a set of spot instruments
+// Currencies are the nodes and every BASE_QUOTE instrument is an edge both ways, each cycle is found once per direction
+// Rates are kept as log rates in one array per leg position, so the edge of a cycle is a plain sum and an update only
+// re-evaluates the cycles its instrument is part of
+struct CycleSet
+{
+    static constexpr double EMPTY = -std::numeric_limits<double>::infinity();
+
+    // BASE_QUOTE, nothing for symbols that aren't a spot pair
+    static std::optional<std::pair<std::string_view, std::string_view>> splitSymbol(std::string_view symbol);
+
+    // instruments are identified by their index in symbols, every symbol must split
+    void build(std::vector<std::string> const& symbols, std::size_t maxLegs = Cycle::MAX_LEGS);
+
+    std::size_t getNumCycles() const { return cycles.size(); }
+    std::size_t getNumCurrencies() const { return currencies.size(); }
+    Cycle const& getCycle(std::size_t index) const { return cycles[index]; }
+    std::span<std::uint32_t const> getCyclesOf(std::uint32_t instrument) const { return cyclesOf[instrument]; }
+
+    // currency the cycle starts in, e.g. "USDC" for USDC -> BTC -> ETH -> USDC
+    std::string_view getStartCurrency(std::size_t index) const;
+
+    // 0 for an empty side, which keeps every cycle through it from triggering
+    [[gnu::hot, gnu::always_inline]]
+    inline void setRates(std::uint32_t instrument, double bid, double ask)
+    {
+        double const sell = bid > 0.0 ? std::log(bid) : EMPTY;
+        double const buy = ask > 0.0 ? -std::log(ask) : EMPTY;
+        for (auto const& slot : slotsOf[instrument])
+            weights[slot.leg][slot.cycle] = slot.isBuy ? buy : sell;
+    }
+
+    // log of the amount a cycle through the instrument ends with per unit it starts with, in the order of getCyclesOf
+    // A cycle is profitable when its edge is above log(1 + fees)
+    [[gnu::hot, gnu::always_inline]]
+    inline std::span<double const> evaluate(std::uint32_t instrument)
+    {
+        auto const& indices = cyclesOf[instrument];
+        std::size_t const count = indices.size();
+        std::uint32_t const* index = indices.data();
+        double const* w0 = weights[0].data();
+        double const* w1 = weights[1].data();
+        double const* w2 = weights[2].data();
+        double const* w3 = weights[3].data();
+        double* out = edges.data();
+
+        // 3 leg cycles have a zero last leg, so every cycle is the same four loads
+#pragma omp simd
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+            std::uint32_t const c = index[i];
+            out[i] = (w0[c] + w1[c]) + (w2[c] + w3[c]);
+        }
+
+        return {out, count};
+    }
+
+private:
+    struct Slot
+    {
+        std::uint32_t cycle;
+        std::uint32_t leg;
+        bool isBuy;
+    };
+
+    std::vector<std::string> currencies;
+    std::vector<std::uint32_t> startCurrency;
+    std::vector<Cycle> cycles;
+    std::vector<std::vector<std::uint32_t>> cyclesOf;
+    std::vector<std::vector<Slot>> slotsOf;
+    std::array<std::vector<double>, Cycle::MAX_LEGS> weights;
+    std::vector<double> edges;
+};
+
+} // namespace phoenix
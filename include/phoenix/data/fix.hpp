@@ -7,6 +7,7 @@
 #include <openssl/evp.h>
 #include <openssl/rand.h>
 
+#include <algorithm>
 #include <array>
 #include <charconv>
 #include <chrono>
@@ -26,11 +27,74 @@
 
 namespace phoenix {
 
+// TestReqID (112) of a TestRequest kept until its heartbeat goes out
+inline constexpr std::size_t TEST_REQ_ID_CAPACITY = 63u;
+
 namespace concepts {
 template<typename T>
 concept Numerical = (std::integral<T> || std::floating_point<T>) && !std::same_as<T, char> && !std::same_as<T, bool>;
 }
 
+namespace detail {
+
+[[gnu::always_inline]]
+inline constexpr int parseDigits(char const* ptr, std::size_t count)
+{
+    int value = 0;
+    for (std::size_t i = 0u; i < count; ++i)
+        value = value * 10 + (ptr[i] - '0');
+
+    return value;
+}
+
+// days since 1970-01-01 of a proleptic Gregorian date
+inline constexpr std::int64_t daysFromCivil(int year, unsigned month, unsigned day)
+{
+    year -= month <= 2u;
+    int const era = (year >= 0 ? year : year - 399) / 400;
+    unsigned const yearOfEra = static_cast<unsigned>(year - era * 400);
+    unsigned const dayOfYear = (153u * (month > 2u ? month - 3u : month + 9u) + 2u) / 5u + day - 1u;
+    unsigned const dayOfEra = yearOfEra * 365u + yearOfEra / 4u - yearOfEra / 100u + dayOfYear;
+    return static_cast<std::int64_t>(era) * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+}
+
+} // namespace detail
+
+// UTCTimestamp (e.g. tag 52) as ns since epoch, YYYYMMDD-HH:MM:SS with up to 9 fractional digits
+// Fixed offsets and no validation beyond the separators, 0 when the field doesn't have the format
+[[gnu::hot]]
+inline constexpr std::int64_t parseUTCTimestamp(std::string_view value)
+{
+    constexpr std::size_t SECONDS_LENGTH = 17u;
+    if (value.size() < SECONDS_LENGTH || value[8] != '-' || value[11] != ':' || value[14] != ':') [[unlikely]]
+        return 0;
+
+    char const* ptr = value.data();
+    std::int64_t const days = detail::daysFromCivil(
+        detail::parseDigits(ptr, 4u),
+        static_cast<unsigned>(detail::parseDigits(ptr + 4, 2u)),
+        static_cast<unsigned>(detail::parseDigits(ptr + 6, 2u)));
+
+    std::int64_t const seconds =
+        days * 86400 + detail::parseDigits(ptr + 9, 2u) * 3600 + detail::parseDigits(ptr + 12, 2u) * 60 +
+        detail::parseDigits(ptr + 15, 2u);
+
+    std::int64_t fraction = 0;
+    std::size_t digits = 0u;
+    if (value.size() > SECONDS_LENGTH + 1u && value[SECONDS_LENGTH] == '.')
+    {
+        digits = std::min<std::size_t>(value.size() - SECONDS_LENGTH - 1u, 9u);
+        fraction = detail::parseDigits(ptr + SECONDS_LENGTH + 1u, digits);
+    }
+
+    constexpr std::array<std::int64_t, 10u> SCALE{
+        1'000'000'000, 100'000'000, 10'000'000, 1'000'000, 100'000, 10'000, 1'000, 100, 10, 1};
+    return seconds * 1'000'000'000 + fraction * SCALE[digits];
+}
+
+static_assert(parseUTCTimestamp("19700101-00:00:01.5") == 1'500'000'000);
+static_assert(parseUTCTimestamp("20240229-12:34:56.789") == 1'709'210'096'789'000'000);
+
 // Zero allocations after construction
 // This will only be constructed on startup if FIXMessageBuilder is used
 struct FIXBuilder
@@ -187,6 +251,35 @@ private:
     std::vector<char> bodyBuffer;
 };
 
+// Whole messages back to back, so a burst of orders costs one write instead of one per order
+// Zero allocations while the batch stays under the reserved capacity
+struct FIXBatch
+{
+    static constexpr std::size_t DEFAULT_CAPACITY = 4096u;
+
+    FIXBatch() { buffer.reserve(DEFAULT_CAPACITY); }
+
+    inline void clear()
+    {
+        buffer.clear();
+        numMessages = 0u;
+    }
+
+    inline void add(std::string_view msg)
+    {
+        buffer.insert(buffer.end(), msg.begin(), msg.end());
+        ++numMessages;
+    }
+
+    inline std::string_view view() const { return {buffer.data(), buffer.size()}; }
+    inline std::size_t getNumMessages() const { return numMessages; }
+    inline bool empty() const { return !numMessages; }
+
+private:
+    std::vector<char> buffer;
+    std::size_t numMessages = 0u;
+};
+
 struct FIXMessageBuilder
 {
     FIXMessageBuilder(std::string_view client)
@@ -247,12 +340,12 @@ struct FIXMessageBuilder
         return builder.serialize();
     }
 
-    inline std::string_view marketDataRequestTopLevel(std::size_t seqNum, std::string_view symbol)
+    inline std::string_view marketDataRequestTopLevel(std::size_t seqNum, std::string_view symbol, unsigned depth = 1u)
     {
         builder.reset(seqNum, "V", client);
         builder.append("262", seqNum);
-        builder.append("263", 0); // full refresh of 1 depth
-        builder.append("264", 1);
+        builder.append("263", 0); // full refresh of depth levels
+        builder.append("264", depth);
         builder.append("55", symbol);
         builder.append("267", 2);
         builder.append("269", 0);
@@ -260,13 +353,14 @@ struct FIXMessageBuilder
         return builder.serialize();
     }
 
-    inline std::string_view marketDataRefreshTriple(std::size_t seqNum, std::vector<std::string> const& instruments)
+    inline std::string_view
+    marketDataRefreshTriple(std::size_t seqNum, std::vector<std::string> const& instruments, unsigned depth = 1u)
     {
         builder.reset(seqNum, "V", client);
         builder.append("262", seqNum);
         builder.append("263", 1);
         builder.append("265", 0);
-        builder.append("264", 1);
+        builder.append("264", depth);
 
         builder.append("146", instruments.size());
         for (auto const& symbol : instruments)
@@ -278,13 +372,13 @@ struct FIXMessageBuilder
         return builder.serialize();
     }
 
-    inline std::string_view marketDataRefreshSingle(std::size_t seqNum, std::string_view instrument)
+    inline std::string_view marketDataRefreshSingle(std::size_t seqNum, std::string_view instrument, unsigned depth = 1u)
     {
         builder.reset(seqNum, "V", client);
         builder.append("262", seqNum);
         builder.append("263", 1);
         builder.append("265", 0);
-        builder.append("264", 1);
+        builder.append("264", depth);
         builder.append("146", 1);
         builder.append("55", instrument);
         builder.append("267", 2);
@@ -297,17 +391,20 @@ struct FIXMessageBuilder
     {
         builder.reset(seqNum, "D", client);
 
+        // order table IDs resolve the execution reports, the sequence number is only unique
+        std::uint64_t const clOrdId = order.clOrdId ? order.clOrdId : seqNum;
+
         char* seqPtr = seqNumBuffer;
         auto const addToSeqBuffer = [&seqPtr](char c) { *seqPtr++ = c; };
         if (order.takeProfit)
         {
             addToSeqBuffer('t');
-            auto result = std::to_chars(seqPtr, seqPtr + sizeof(seqNumBuffer), seqNum);
+            auto result = std::to_chars(seqPtr, seqPtr + sizeof(seqNumBuffer), clOrdId);
             *result.ptr = '\0';
             builder.append("11", seqNumBuffer);
         }
         else
-            builder.append("11", seqNum);
+            builder.append("11", clOrdId);
 
         builder.append("54", order.side);
         builder.append("38", order.volume.str());
@@ -323,7 +420,7 @@ struct FIXMessageBuilder
     inline std::string_view newMarketOrderSingle(std::size_t seqNum, auto const& order)
     {
         builder.reset(seqNum, "D", client);
-        builder.append("11", seqNum);
+        builder.append("11", order.clOrdId ? order.clOrdId : seqNum);
         builder.append("40", 1);
         /*builder.append("44", order.price.str());*/
         builder.append("38", order.volume.str());
@@ -344,6 +441,30 @@ struct FIXMessageBuilder
         return builder.serialize();
     }
 
+    // With our ClOrdID in 11, so a cancel reject names the order it was for
+    inline std::string_view orderCancelRequest(std::size_t seqNum, std::string_view symbol, std::string_view orderId, std::uint64_t clOrdId)
+    {
+        builder.reset(seqNum, "F", client);
+        builder.append("41", orderId);
+        builder.append("11", clOrdId ? clOrdId : seqNum);
+        builder.append("55", symbol);
+        return builder.serialize();
+    }
+
+    // Amends price and size of a resting order in one message, the order keeps its ClOrdID
+    inline std::string_view orderCancelReplaceRequest(std::size_t seqNum, std::string_view symbol, auto const& order)
+    {
+        builder.reset(seqNum, "G", client);
+        builder.append("41", order.orderId.view());
+        builder.append("11", order.clOrdId ? order.clOrdId : seqNum);
+        builder.append("40", 2);
+        builder.append("54", order.side);
+        builder.append("38", order.volume.str());
+        builder.append("44", order.price.str());
+        builder.append("55", symbol);
+        return builder.serialize();
+    }
+
     inline std::string_view requestForPositions(std::size_t seqNum)
     {
         builder.reset(seqNum, "AN", client);
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "phoenix/data/order_table.hpp"
+#include "phoenix/data/orders.hpp"
+#include "phoenix/tools/fixed_string.hpp"
+#include "phoenix/tools/shm_ring.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace phoenix {
+
+// An order from a strategy to the gateway, with price and volume already as the text of 44 and 38
+// so one gateway serves strategies of any decimal precision
+struct GatewayOrder
+{
+    static constexpr std::size_t SYMBOL_CAPACITY = 31u;
+    static constexpr std::size_t DECIMAL_CAPACITY = 23u;
+
+    OrderAction action;
+    Priority priority;
+    std::uint8_t side;
+    std::uint8_t batchSize; // records from this one on that go out together or not at all, 1 for a single order
+    bool takeProfit;
+    bool isFOK;
+
+    ClOrdId clOrdId;
+    FixedString<SYMBOL_CAPACITY> symbol;
+    FixedString<DECIMAL_CAPACITY> price;
+    FixedString<DECIMAL_CAPACITY> volume;
+    FixedString<ORDER_ID_CAPACITY> orderId;
+};
+
+// An execution report or cancel reject from the gateway to a strategy, as received
+struct GatewayReport
+{
+    static constexpr std::size_t MAX_SIZE = 4096u - sizeof(std::uint32_t);
+
+    std::uint32_t size;
+    char data[MAX_SIZE];
+
+    std::string_view view() const { return {data, size}; }
+};
+
+// Shared memory between the gateway and one strategy process, created by the gateway under the name the strategy sets in gateway
+// Orders have a ring per priority, so a cancel or a hedge of a channel never waits behind quotes it pushed earlier
+// A restarted gateway creates its channels anew under a new epoch, a strategy still on the old one has to be restarted too
+struct GatewayChannel
+{
+    static constexpr std::uint64_t MAGIC = 0x59575447584e4850ull; // PHNXGTWY
+    static constexpr std::uint32_t VERSION = 3u;
+    static constexpr std::size_t ORDER_CAPACITY = 256u;
+    static constexpr std::size_t REPORT_CAPACITY = 256u;
+
+    struct alignas(64) Header
+    {
+        std::atomic<std::uint64_t> magic; // stored last with release once the rest is set, back to 0 when the gateway stops
+        std::uint32_t version;
+        std::uint32_t route; // stamped above CL_ORD_ID_ROUTE_SHIFT of every ClOrdID of the channel
+        std::uint64_t epoch; // of the gateway run that created the channel
+        std::atomic<std::uint64_t> dropped; // reports the strategy was too slow for
+    };
+
+    Header header;
+    std::array<ShmRing<GatewayOrder, ORDER_CAPACITY>, NUM_PRIORITIES> orders;
+    ShmRing<GatewayReport, REPORT_CAPACITY> reports;
+};
+
+// copies an order of any decimal types into the record the gateway encodes
+template<typename Order>
+[[gnu::hot, gnu::always_inline]]
+inline void toGatewayOrder(GatewayOrder& record, Priority priority, OrderAction action, Order const& order, std::size_t batchSize = 1u)
+{
+    record.action = action;
+    record.priority = priority;
+    record.side = static_cast<std::uint8_t>(order.side);
+    record.batchSize = static_cast<std::uint8_t>(batchSize);
+    record.takeProfit = order.takeProfit;
+    record.isFOK = order.isFOK;
+    record.clOrdId = order.clOrdId;
+    record.symbol = order.symbol;
+    record.price = order.price.str();
+    record.volume = order.volume.str();
+    record.orderId = order.orderId.view();
+}
+
+} // namespace phoenix
@@ -0,0 +1,348 @@
+#pragma once
+
+#include "phoenix/data/fix.hpp"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace phoenix {
+
+// Order book stored as a contiguous ladder of Levels ticks around an anchor price
+// Levels are indexed by (price - anchor) / tickSize, and an occupancy bitmap finds the next level in a few words
+// The window stays on the touch, a level outside of it is dropped (see getDroppedLevels) unless it's a new best level,
+// then the window re-centres on the touch and the levels that fall off the far side are dropped instead
+// A dropped level is gone for good, so depth near the edges of the window is unreliable until the next snapshot (35=W)
+// Price and Volume are fixed point Decimal types
+template<typename Price, typename Volume, std::size_t Levels = 8192u>
+struct LadderBook
+{
+    static_assert(Levels % 64u == 0u && std::has_single_bit(Levels), "Levels must be a power of two multiple of 64");
+
+    using Level = std::pair<Price, Volume>;
+
+    explicit LadderBook(Price tickSize)
+        : tick{tickSize.getValue()}
+    {
+        assert(tick && "Tick size must be positive");
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void pushBid(Price price, Volume volume)
+    {
+        push(bids, price, volume);
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void pushAsk(Price price, Volume volume)
+    {
+        push(asks, price, volume);
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void popBid(Price price)
+    {
+        pop(bids, price);
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void popAsk(Price price)
+    {
+        pop(asks, price);
+    }
+
+    Level getBestBid() const { return getLevel(bids, bids.best); }
+    Level getBestAsk() const { return getLevel(asks, asks.best); }
+
+    Level getNthBestBid(std::size_t n) const
+    {
+        std::int64_t index = bids.best;
+        for (std::size_t i = 0u; i < n && index != NONE; ++i)
+            index = findBelow(bids, index - 1);
+
+        return getLevel(bids, index);
+    }
+
+    Level getNthBestAsk(std::size_t n) const
+    {
+        std::int64_t index = asks.best;
+        for (std::size_t i = 0u; i < n && index != NONE; ++i)
+            index = findAbove(asks, index + 1);
+
+        return getLevel(asks, index);
+    }
+
+    std::size_t getNumBids() const { return bids.count; }
+    std::size_t getNumAsks() const { return asks.count; }
+    std::uint64_t getDroppedLevels() const { return droppedLevels; }
+
+    // the next push anchors the window around its price
+    void clear()
+    {
+        bids.clear();
+        asks.clear();
+        anchor = UNANCHORED;
+    }
+
+    // a snapshot replaces the whole book
+    void fromSnapshot(FIXReaderFast& reader)
+    {
+        clear();
+
+        std::size_t const numUpdates = reader.getNumber<std::size_t>(268);
+        for (std::size_t i = 0u; i < numUpdates; ++i)
+        {
+            unsigned const typeField = reader.getNumber<unsigned>(269, i);
+
+            auto const price = reader.getDecimal<Price>(270, i);
+            auto const volume = reader.getDecimal<Volume>(271, i);
+
+            if (typeField == 0u)
+                pushBid(price, volume);
+            else if (typeField == 1u)
+                pushAsk(price, volume);
+        }
+    }
+
+    void fromUpdate(FIXReaderFast& reader)
+    {
+        std::size_t const numUpdates = reader.getNumber<std::size_t>(268);
+        for (std::size_t i = 0u; i < numUpdates; ++i)
+        {
+            unsigned const typeField = reader.getNumber<unsigned>(269, i);
+            unsigned const actionField = reader.getNumber<unsigned>(279, i);
+
+            auto const price = reader.getDecimal<Price>(270, i);
+            auto const volume = reader.getDecimal<Volume>(271, i);
+
+            if (typeField == 0u)
+            {
+                if (actionField == 2u)
+                    popBid(price);
+                else
+                    pushBid(price, volume);
+            }
+            else if (typeField == 1u)
+            {
+                if (actionField == 2u)
+                    popAsk(price);
+                else
+                    pushAsk(price, volume);
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t WORDS = Levels / 64u;
+    static constexpr std::int64_t NONE = -1;
+    static constexpr std::int64_t UNANCHORED = std::numeric_limits<std::int64_t>::min() / 2; // every index is outside
+
+    struct Side
+    {
+        void clear()
+        {
+            volumes.fill(0u);
+            occupied.fill(0u);
+            count = 0u;
+            best = NONE;
+        }
+
+        std::array<std::uint64_t, Levels> volumes{};
+        std::array<std::uint64_t, WORDS> occupied{};
+        std::size_t count = 0u;
+        std::int64_t best = NONE; // highest index for bids, lowest for asks
+        bool isBid = false;
+    };
+
+    [[gnu::hot, gnu::always_inline]]
+    inline std::int64_t toIndex(Price price) const
+    {
+        return static_cast<std::int64_t>(price.getValue() / tick) - anchor;
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline static bool inWindow(std::int64_t index)
+    {
+        return index >= 0 && index < static_cast<std::int64_t>(Levels);
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void push(Side& side, Price price, Volume volume)
+    {
+        if (!volume) [[unlikely]]
+            return pop(side, price);
+
+        assert(price.getValue() % tick == 0u && "Price is not a multiple of the tick size");
+        std::int64_t index = toIndex(price);
+        if (!inWindow(index)) [[unlikely]]
+        {
+            // a deep or stray level never moves the window off the touch
+            if (side.best != NONE && (side.isBid ? index < side.best : index > side.best))
+            {
+                ++droppedLevels;
+                return;
+            }
+
+            recenter(side, static_cast<std::int64_t>(price.getValue() / tick));
+            index = toIndex(price);
+        }
+
+        auto& level = side.volumes[index];
+        if (!level)
+        {
+            side.occupied[index >> 6u] |= 1ull << (index & 63);
+            ++side.count;
+
+            if (side.best == NONE || (side.isBid ? index > side.best : index < side.best))
+                side.best = index;
+        }
+
+        level = volume.getValue();
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void pop(Side& side, Price price)
+    {
+        std::int64_t const index = toIndex(price);
+        if (!inWindow(index) || !side.volumes[index]) [[unlikely]]
+            return;
+
+        side.volumes[index] = 0u;
+        side.occupied[index >> 6u] &= ~(1ull << (index & 63));
+        --side.count;
+
+        if (index == side.best)
+            side.best = side.isBid ? findBelow(side, index - 1) : findAbove(side, index + 1);
+    }
+
+    // highest occupied index at or below from
+    static std::int64_t findBelow(Side const& side, std::int64_t from)
+    {
+        if (from < 0)
+            return NONE;
+
+        std::int64_t word = from >> 6u;
+        std::uint64_t bits = side.occupied[word] & (~0ull >> (63 - (from & 63)));
+        while (!bits)
+        {
+            if (--word < 0)
+                return NONE;
+
+            bits = side.occupied[word];
+        }
+
+        return (word << 6u) + 63 - std::countl_zero(bits);
+    }
+
+    // lowest occupied index at or above from
+    static std::int64_t findAbove(Side const& side, std::int64_t from)
+    {
+        if (from >= static_cast<std::int64_t>(Levels))
+            return NONE;
+
+        std::int64_t word = from >> 6u;
+        std::uint64_t bits = side.occupied[word] & (~0ull << (from & 63));
+        while (!bits)
+        {
+            if (++word == static_cast<std::int64_t>(WORDS))
+                return NONE;
+
+            bits = side.occupied[word];
+        }
+
+        return (word << 6u) + std::countr_zero(bits);
+    }
+
+    Level getLevel(Side const& side, std::int64_t index) const
+    {
+        if (index == NONE) [[unlikely]]
+            return {};
+
+        return {Price{static_cast<std::uint64_t>(index + anchor) * tick}, Volume{side.volumes[index]}};
+    }
+
+    // Slow path, moves the window onto the new best tick of side, in the middle of the spread while the other touch fits
+    [[gnu::cold, gnu::noinline]]
+    void recenter(Side const& side, std::int64_t tickIndex)
+    {
+        Side const& other = side.isBid ? asks : bids;
+        std::int64_t center = tickIndex;
+        if (other.best != NONE)
+        {
+            std::int64_t const otherTick = other.best + anchor;
+            std::int64_t const mid = tickIndex + (otherTick - tickIndex) / 2;
+            if (std::abs(otherTick - tickIndex) < static_cast<std::int64_t>(Levels) - 1)
+                center = mid;
+        }
+
+        std::int64_t const newAnchor = center - static_cast<std::int64_t>(Levels / 2u);
+        if (!bids.count && !asks.count)
+        {
+            anchor = newAnchor;
+            return;
+        }
+
+        std::int64_t const shift = newAnchor - anchor;
+        anchor = newAnchor;
+        shiftSide(bids, shift);
+        shiftSide(asks, shift);
+    }
+
+    // Moves the levels in place, the bitmap is rebuilt from the volumes that are left
+    void shiftSide(Side& side, std::int64_t shift)
+    {
+        if (!shift || !side.count)
+            return;
+
+        std::size_t const before = side.count;
+        std::size_t const distance = static_cast<std::size_t>(std::abs(shift));
+        if (distance >= Levels)
+        {
+            side.clear();
+            droppedLevels += before;
+            return;
+        }
+
+        auto* volumes = side.volumes.data();
+        std::size_t const kept = Levels - distance;
+        if (shift > 0)
+        {
+            std::memmove(volumes, volumes + distance, kept * sizeof(std::uint64_t));
+            std::memset(volumes + kept, 0, distance * sizeof(std::uint64_t));
+        }
+        else
+        {
+            std::memmove(volumes + distance, volumes, kept * sizeof(std::uint64_t));
+            std::memset(volumes, 0, distance * sizeof(std::uint64_t));
+        }
+
+        side.occupied.fill(0u);
+        side.count = 0u;
+        for (std::size_t i = 0u; i < Levels; ++i)
+        {
+            if (!volumes[i])
+                continue;
+
+            side.occupied[i >> 6u] |= 1ull << (i & 63u);
+            ++side.count;
+        }
+
+        droppedLevels += before - side.count;
+        side.best = side.isBid ? findBelow(side, Levels - 1) : findAbove(side, 0);
+    }
+
+    std::uint64_t const tick;
+    std::int64_t anchor = UNANCHORED;
+    std::uint64_t droppedLevels = 0u;
+
+    Side bids{.isBid = true};
+    Side asks{.isBid = false};
+};
+
+} // namespace phoenix
@@ -1,78 +1,61 @@
 #pragma once
 
 #include "phoenix/data/fix.hpp"
+#include "phoenix/tools/node_arena.hpp"
 
-#include <boost/unordered/unordered_flat_map.hpp>
-
-#include <array>
+#include <cassert>
 #include <cstdint>
 #include <map>
+#include <memory>
+#include <type_traits>
 #include <utility>
-#include <vector>
 
 namespace phoenix {
 
 namespace detail {
+// Allocator over a NodeArena, copies and rebinds share the arena of the book that created them
 template<typename T>
 struct NodePool
 {
     using value_type = T;
     using size_type = std::size_t;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
 
-    static NodePool& getInstance()
-    {
-        static NodePool instance{true};
-        return instance;
-    }
+    static_assert(alignof(T) <= NodeArena::NODE_ALIGNMENT);
 
-    NodePool() = default;
+    explicit NodePool(NodeArena& arena)
+        : arena{&arena}
+    {}
 
-    value_type* allocate(std::size_t n)
+    template<typename U>
+    NodePool(NodePool<U> const& other)
+        : arena{other.arena}
+    {}
+
+    [[gnu::hot, gnu::always_inline]]
+    inline value_type* allocate(std::size_t n)
     {
         assert(n == 1u);
-        auto& self = getInstance();
-
-        auto curr = self.index;
-        while (!self.pool[curr].isFree)
-            curr = (curr + 1u) & PREALLOCATOR_MASK;
-
-        self.index = (curr + 1u) & PREALLOCATOR_MASK;
-        auto* freeNode = &self.pool[curr];
-        freeNode->isFree = false;
-        return &freeNode->value;
+        return static_cast<value_type*>(arena->allocate(sizeof(value_type)));
     }
 
-    void deallocate(value_type* node, std::size_t)
+    [[gnu::hot, gnu::always_inline]]
+    inline void deallocate(value_type* node, std::size_t)
     {
-        auto& self = getInstance();
-        auto it = self.addresses.find(node);
-        assert(it != self.addresses.end());
-        self.pool[it->second].isFree = true;
+        arena->deallocate(node);
     }
 
-private:
-    NodePool(bool)
+    template<typename U>
+    bool operator==(NodePool<U> const& other) const
     {
-        pool.resize(PREALLOCATOR_SIZE);
-        for (std::size_t i = 0u; i < PREALLOCATOR_SIZE; ++i)
-            addresses[&(pool[i].value)] = i;
-        index = 0u;
+        return arena == other.arena;
     }
 
-    // assuming std::map doesn't do pointer arithmetic
-    struct Node 
-    {
-        value_type value; 
-        bool isFree = true;
-    };
-
-    static constexpr std::size_t PREALLOCATOR_SIZE = 65536u;
-    static constexpr std::size_t PREALLOCATOR_MASK = PREALLOCATOR_SIZE - 1u;
-    std::vector<Node> pool;
-    boost::unordered_flat_map<value_type const*, std::size_t> addresses;
-    std::size_t index = 0u;
+    NodeArena* arena;
 };
-}
+} // namespace detail
 
 template<typename Price, typename Volume>
 struct OrderBook
@@ -81,11 +64,82 @@ struct OrderBook
     using BidMap = std::map<Price, Volume, std::greater<>, Allocator>;
     using AskMap = std::map<Price, Volume, std::less<>, Allocator>;
 
-    void pushBid(Price price, Volume volume) { bids[price] = volume; }
-    void pushAsk(Price price, Volume volume) { asks[price] = volume; }
+    // both sides share one arena per book, hugePages backs it with MAP_HUGETLB where available
+    explicit OrderBook(bool hugePages = false)
+        : arena{std::make_unique<NodeArena>(hugePages)}
+        , bids{Allocator{*arena}}
+        , asks{Allocator{*arena}}
+    {}
+
+    // Result of taking a quantity from one side, best level first
+    struct Sweep
+    {
+        Volume volume{};       // less than requested when the side runs out
+        double notional = 0.0; // sum of price * volume over the levels taken
+        Price worstPrice{};    // last level touched, a limit price that fills the whole sweep
+        bool isComplete = false;
+
+        double getAveragePrice() const { return volume ? notional / volume.asDouble() : 0.0; }
+    };
 
-    void popBid(Price price) { bids.erase(price); }
-    void popAsk(Price price) { asks.erase(price); }
+    NodeArena const& getArena() const { return *arena; }
+
+    void pushBid(Price price, Volume volume)
+    {
+        bids[price] = volume;
+        bidCache.invalidate(bids, price);
+    }
+
+    void pushAsk(Price price, Volume volume)
+    {
+        asks[price] = volume;
+        askCache.invalidate(asks, price);
+    }
+
+    void popBid(Price price)
+    {
+        bids.erase(price);
+        bidCache.invalidate(bids, price);
+    }
+
+    void popAsk(Price price)
+    {
+        asks.erase(price);
+        askCache.invalidate(asks, price);
+    }
+
+    void clear()
+    {
+        bids.clear();
+        asks.clear();
+        bidCache = {};
+        askCache = {};
+    }
+
+    std::size_t getNumBids() const { return bids.size(); }
+    std::size_t getNumAsks() const { return asks.size(); }
+
+    // visitor(price, volume) over at most depth levels, best first
+    template<typename Visitor>
+    void visitBids(std::size_t depth, Visitor&& visitor) const
+    {
+        visit(bids, depth, visitor);
+    }
+
+    template<typename Visitor>
+    void visitAsks(std::size_t depth, Visitor&& visitor) const
+    {
+        visit(asks, depth, visitor);
+    }
+
+    // Depth queries walk the side once from the top and keep their last result
+    // An update only drops a result when it lands on a level the result depends on
+    Sweep getBuyCost(Volume quantity) const { return sweep(asks, askCache, quantity); }
+    Sweep getSellCost(Volume quantity) const { return sweep(bids, bidCache, quantity); }
+
+    // quantity available at limit or better
+    Volume getBuyableWithin(Price limit) const { return within(asks, askCache, limit); }
+    Volume getSellableWithin(Price limit) const { return within(bids, bidCache, limit); }
 
     auto getBestBid() const
     {
@@ -117,8 +171,11 @@ struct OrderBook
         return *it;
     }
 
+    // a snapshot replaces the whole book
     void fromSnapshot(FIXReaderFast& reader)
     {
+        clear();
+
         std::size_t const numUpdates = reader.getNumber<std::size_t>(268);
         for (std::size_t i = 0u; i < numUpdates; ++i)
         {
@@ -163,8 +220,95 @@ struct OrderBook
     }
 
 private:
+    struct Cache
+    {
+        // only levels at or better than the reach of a result can change it
+        template<typename Map>
+        void invalidate(Map const& side, Price price)
+        {
+            auto const comesBefore = side.key_comp();
+            if (hasSweep && (!sweep.isComplete || !comesBefore(sweep.worstPrice, price)))
+                hasSweep = false;
+
+            if (hasWithin && !comesBefore(withinLimit, price))
+                hasWithin = false;
+        }
+
+        Volume sweepQuantity{};
+        Sweep sweep;
+        bool hasSweep = false;
+
+        Price withinLimit{};
+        Volume withinVolume{};
+        bool hasWithin = false;
+    };
+
+    template<typename Map, typename Visitor>
+    static void visit(Map const& side, std::size_t depth, Visitor& visitor)
+    {
+        for (auto it = side.begin(); it != side.end() && depth; ++it, --depth)
+            visitor(it->first, it->second);
+    }
+
+    template<typename Map>
+    static Sweep sweep(Map const& side, Cache& cache, Volume quantity)
+    {
+        if (cache.hasSweep && cache.sweepQuantity == quantity)
+            return cache.sweep;
+
+        Sweep result;
+        Volume remaining = quantity;
+        for (auto const& [price, volume] : side)
+        {
+            Volume const taken = volume < remaining ? volume : remaining;
+            result.volume += taken;
+            result.notional += price.asDouble() * taken.asDouble();
+            result.worstPrice = price;
+            remaining -= taken;
+
+            if (!remaining)
+            {
+                result.isComplete = true;
+                break;
+            }
+        }
+
+        cache.sweepQuantity = quantity;
+        cache.sweep = result;
+        cache.hasSweep = true;
+        return result;
+    }
+
+    template<typename Map>
+    static Volume within(Map const& side, Cache& cache, Price limit)
+    {
+        if (cache.hasWithin && cache.withinLimit == limit)
+            return cache.withinVolume;
+
+        auto const comesBefore = side.key_comp();
+        Volume result{};
+        for (auto const& [price, volume] : side)
+        {
+            if (comesBefore(limit, price))
+                break;
+
+            result += volume;
+        }
+
+        cache.withinLimit = limit;
+        cache.withinVolume = result;
+        cache.hasWithin = true;
+        return result;
+    }
+
+    // heap allocated so that moving the book keeps the allocators valid, and declared first so it outlives the maps
+    std::unique_ptr<NodeArena> arena;
     BidMap bids;
     AskMap asks;
+
+    // queries are logically const
+    mutable Cache bidCache;
+    mutable Cache askCache;
 };
 
 } // namespace phoenix
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace phoenix {
+
+// ClOrdID (11) of an order from an OrderTable, the slot in the low bits and the generation of the slot above them
+// Never 0, so 0 can stand for an order that isn't in a table
+using ClOrdId = std::uint64_t;
+
+// Bits from here up are left to an order gateway, which stamps the session of the strategy there to route its reports back
+// Tables ignore them, so a report resolves the same with or without a route
+inline constexpr unsigned CL_ORD_ID_ROUTE_SHIFT = 56u;
+
+inline constexpr ClOrdId withRoute(ClOrdId id, std::uint32_t route) { return id | (ClOrdId{route} << CL_ORD_ID_ROUTE_SHIFT); }
+inline constexpr std::uint32_t getRoute(ClOrdId id) { return static_cast<std::uint32_t>(id >> CL_ORD_ID_ROUTE_SHIFT); }
+
+// as sent in 11, a letter prefix like the 't' of take profit orders is skipped, 0 when it isn't a number
+[[gnu::hot, gnu::always_inline]]
+inline ClOrdId parseClOrdId(std::string_view id)
+{
+    char const* begin = id.data();
+    char const* end = begin + id.size();
+    if (begin != end && (*begin < '0' || *begin > '9'))
+        ++begin;
+
+    ClOrdId value = 0u;
+    auto const [ptr, error] = std::from_chars(begin, end, value);
+    if (error != std::errc{} || ptr != end) [[unlikely]]
+        return 0u;
+
+    return value;
+}
+
+// Open orders in a fixed pool of slots, looked up by the ClOrdID the exchange echoes back instead of a hash or a string
+// Every insert bumps the generation of its slot, so a late report for an erased order doesn't resolve to the next one
+template<typename Record, std::size_t CAPACITY>
+struct OrderTable
+{
+    static_assert(std::has_single_bit(CAPACITY));
+    static constexpr unsigned SLOT_BITS = std::countr_zero(CAPACITY);
+    static constexpr ClOrdId SLOT_MASK = CAPACITY - 1u;
+    static_assert(SLOT_BITS + 32u <= CL_ORD_ID_ROUTE_SHIFT);
+
+    OrderTable()
+    {
+        // lowest slots first, so a quiet table keeps its orders in a few cache lines
+        for (std::size_t i = 0u; i < CAPACITY; ++i)
+            freeSlots[i] = static_cast<std::uint32_t>(CAPACITY - 1u - i);
+    }
+
+    OrderTable(OrderTable const&) = delete;
+    OrderTable& operator=(OrderTable const&) = delete;
+
+    // 0 when every slot is taken
+    [[gnu::hot, gnu::always_inline]]
+    inline ClOrdId insert(Record const& record)
+    {
+        if (!numFree) [[unlikely]]
+            return 0u;
+
+        std::uint32_t const slot = freeSlots[--numFree];
+        auto& entry = entries[slot];
+        entry.record = record;
+        entry.isOpen = true;
+        return (ClOrdId{++entry.generation} << SLOT_BITS) | slot;
+    }
+
+    // nullptr for an erased order or an ID from somewhere else
+    [[gnu::hot, gnu::always_inline]]
+    inline Record* find(ClOrdId id)
+    {
+        auto& entry = entries[id & SLOT_MASK];
+        if (!entry.isOpen || entry.generation != static_cast<std::uint32_t>(id >> SLOT_BITS)) [[unlikely]]
+            return nullptr;
+
+        return &entry.record;
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline Record* find(std::string_view id) { return find(parse(id)); }
+
+    // 0 when it isn't one of ours
+    [[gnu::hot, gnu::always_inline]]
+    static inline ClOrdId parse(std::string_view id) { return parseClOrdId(id); }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline bool erase(ClOrdId id)
+    {
+        if (!find(id))
+            return false;
+
+        auto const slot = static_cast<std::uint32_t>(id & SLOT_MASK);
+        entries[slot].isOpen = false;
+        freeSlots[numFree++] = slot;
+        return true;
+    }
+
+    std::size_t getSize() const { return CAPACITY - numFree; }
+    static constexpr std::size_t getCapacity() { return CAPACITY; }
+
+private:
+    struct Entry
+    {
+        Record record{};
+        std::uint32_t generation = 0u;
+        bool isOpen = false;
+    };
+
+    std::array<Entry, CAPACITY> entries{};
+    std::array<std::uint32_t, CAPACITY> freeSlots{};
+    std::size_t numFree = CAPACITY;
+};
+
+} // namespace phoenix
@@ -1,9 +1,22 @@
 #pragma once
 
+#include "phoenix/common/logger.hpp"
+#include "phoenix/data/order_table.hpp"
+#include "phoenix/tools/fixed_string.hpp"
+
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 
 namespace phoenix {
 
+// exchange order IDs are kept inline, e.g. ETH-16582815042 on Deribit
+inline constexpr std::size_t ORDER_ID_CAPACITY = 31u;
+
+// order sessions an order can go out on, the main one and the subaccounts of a SessionPool
+inline constexpr std::size_t MAX_SESSIONS = 8u;
+
 template<typename Traits>
 struct SingleOrder
 {
@@ -23,8 +36,62 @@ struct SingleOrder
     bool isCancelled = false;
     bool isInFlight = true;
     
-    std::string orderId;
+    FixedString<ORDER_ID_CAPACITY> orderId{};
+    ClOrdId clOrdId = 0u; // 0 sends the sequence number instead
+    std::uint8_t session = 0u; // of the SessionPool, 0 for the main session, every message of an order on the same one
     std::chrono::steady_clock::time_point lastSent = std::chrono::steady_clock::now();
 };
 
+// Keeps the exchange ID of an ack, false and nothing kept when it doesn't fit
+// an ID cut short would cancel or replace some other order, so the caller leaves the order in flight instead
+template<typename Traits>
+[[nodiscard]] inline bool setOrderId(SingleOrder<Traits>& order, std::string_view orderId)
+{
+    FixedString<ORDER_ID_CAPACITY> const id{orderId};
+    if (id.wasTruncated()) [[unlikely]]
+        return false;
+
+    order.orderId = id;
+    return true;
+}
+
+// setOrderId for an ack, the ack is logged as rejected when its ID doesn't fit
+template<typename Handler, typename Traits>
+[[nodiscard]] inline bool acceptOrderId(Handler* handler, SingleOrder<Traits>& order, std::string_view orderId)
+{
+    if (!setOrderId(order, orderId)) [[unlikely]]
+    {
+        PHOENIX_LOG_ERROR(handler, "[ACK REJECTED] Order ID too long to keep", orderId);
+        return false;
+    }
+
+    return true;
+}
+
+// One message of a batch or of the Scheduler, the order is encoded as is
+enum class OrderAction
+{
+    NEW,     // 35=D
+    REPLACE, // 35=G, amends the resting order with the exchange ID in orderId
+    CANCEL   // 35=F, of the resting order with the exchange ID in orderId
+};
+
+// Release order of outbound messages, a class only goes out once every class above it is empty
+enum class Priority : std::uint8_t
+{
+    CANCEL, // takes risk off the book
+    HEDGE,  // legs and take profits, a position is open until they go out
+    QUOTE,  // new and replaced quotes
+    ADMIN   // session messages, the heartbeat goes out after all of them
+};
+
+inline constexpr std::size_t NUM_PRIORITIES = static_cast<std::size_t>(Priority::ADMIN) + 1u;
+
+template<typename Traits>
+struct OrderRequest
+{
+    OrderAction action;
+    SingleOrder<Traits> const* order;
+};
+
 } // namespace phoenix
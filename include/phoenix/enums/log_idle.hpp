@@ -0,0 +1,34 @@
+#pragma once
+
+#include <boost/describe.hpp>
+
+#include <iostream>
+#include <string>
+
+namespace phoenix {
+// What the logger thread does while there is nothing to write
+// SPIN: busy polls with pause, lowest latency but burns its core
+// YIELD: polls with sched_yield in between
+// BACKOFF: spins, then pauses, then yields and finally parks on a futex until the trading thread wakes it
+BOOST_DEFINE_ENUM_CLASS(LogIdle, SPIN, YIELD, BACKOFF)
+inline char const* logIdleString(LogIdle policy) { return boost::describe::enum_to_string(policy, 0); }
+} // namespace phoenix
+
+namespace std {
+inline std::istream& operator>>(std::istream& in, phoenix::LogIdle& policy)
+{
+    std::string token;
+    in >> token;
+
+    if (!boost::describe::enum_from_string<phoenix::LogIdle>(token.c_str(), policy))
+        in.setstate(std::ios_base::failbit);
+
+    return in;
+}
+
+inline std::ostream& operator<<(std::ostream& os, phoenix::LogIdle policy)
+{
+    os << phoenix::logIdleString(policy);
+    return os;
+}
+} // namespace std
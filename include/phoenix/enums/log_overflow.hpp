@@ -0,0 +1,34 @@
+#pragma once
+
+#include <boost/describe.hpp>
+
+#include <iostream>
+#include <string>
+
+namespace phoenix {
+// What the trading thread does when the logger ring is full, it never waits for the logger thread
+// DROP: drop the entry
+// DROP_VERBOSE: DEBUG/INFO entries are dropped early to keep headroom for WARN and above
+// SPILL: continue in a secondary preallocated ring, drop once that is full too
+BOOST_DEFINE_ENUM_CLASS(LogOverflow, DROP, DROP_VERBOSE, SPILL)
+inline char const* logOverflowString(LogOverflow policy) { return boost::describe::enum_to_string(policy, 0); }
+} // namespace phoenix
+
+namespace std {
+inline std::istream& operator>>(std::istream& in, phoenix::LogOverflow& policy)
+{
+    std::string token;
+    in >> token;
+
+    if (!boost::describe::enum_from_string<phoenix::LogOverflow>(token.c_str(), policy))
+        in.setstate(std::ios_base::failbit);
+
+    return in;
+}
+
+inline std::ostream& operator<<(std::ostream& os, phoenix::LogOverflow policy)
+{
+    os << phoenix::logOverflowString(policy);
+    return os;
+}
+} // namespace std
@@ -61,12 +61,13 @@ Node& getNode(Router<Config, Traits, NodeList<Nodes...>>& graph)
 // Statically checks if the called functions are implemented
 // Can be simplified a bit more imo
 // Note: retrieval functions can return lval or ptr
-template<typename _Config, typename Traits, template<typename> class... Nodes>
-struct Router<_Config, Traits, NodeList<Nodes...>>
-    : public RouterHandler<Router<_Config, Traits, NodeList<Nodes...>>>
-    , public Nodes<NodeBase<Traits, Router<_Config, Traits, NodeList<Nodes...>>, _Config>>...
+template<typename _Config, typename _Traits, template<typename> class... Nodes>
+struct Router<_Config, _Traits, NodeList<Nodes...>>
+    : public RouterHandler<Router<_Config, _Traits, NodeList<Nodes...>>>
+    , public Nodes<NodeBase<_Traits, Router<_Config, _Traits, NodeList<Nodes...>>, _Config>>...
 {
     using Config = _Config;
+    using Traits = _Traits;
 
     Router(Config const& config)
         : Nodes<NodeBase<Traits, Router, Config>>(config, static_cast<RouterHandler<Router>&>(*this))...
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "phoenix/data/ladder_book.hpp"
+
+#include <cstddef>
+
+namespace phoenix::convergence {
+
+// Book of the quoted instrument to --book-depth levels, kept by the Stream from W snapshots and X incrementals
+// Convergence pairs trade in a narrow band around 1, so a tick indexed ladder covers every level subscribed to
+// Levels dropped when the window re-centres are only back with the next W snapshot, the quoters read the touch side of it
+template<typename Traits>
+using Book = LadderBook<typename Traits::PriceType, typename Traits::VolumeType>;
+
+namespace detail {
+
+// levels checked for someone else's quantity, past every level a ladder of ours can take
+inline constexpr std::size_t MAX_OWN_LEVELS = 16u;
+
+template<typename Level, typename OwnVolume>
+inline bool isOnlyOurs(Level const& level, OwnVolume&& ownVolumeAt)
+{
+    return level.second <= ownVolumeAt(level.first);
+}
+
+} // namespace detail
+
+// Best bid of everyone else, levels that only hold our own quotes are skipped, 0 without one
+// ownVolumeAt(price) is the quantity we rest at a price, so the quoter never steps up against itself
+template<typename Traits, typename OwnVolume>
+inline auto getCompetingBid(Book<Traits> const& book, OwnVolume&& ownVolumeAt)
+{
+    for (std::size_t n = 0u; n < book.getNumBids() && n < detail::MAX_OWN_LEVELS; ++n)
+    {
+        auto const level = book.getNthBestBid(n);
+        if (!detail::isOnlyOurs(level, ownVolumeAt))
+            return level.first;
+    }
+
+    return typename Traits::PriceType{};
+}
+
+template<typename Traits, typename OwnVolume>
+inline auto getCompetingAsk(Book<Traits> const& book, OwnVolume&& ownVolumeAt)
+{
+    for (std::size_t n = 0u; n < book.getNumAsks() && n < detail::MAX_OWN_LEVELS; ++n)
+    {
+        auto const level = book.getNthBestAsk(n);
+        if (!detail::isOnlyOurs(level, ownVolumeAt))
+            return level.first;
+    }
+
+    return typename Traits::PriceType{};
+}
+
+} // namespace phoenix::convergence
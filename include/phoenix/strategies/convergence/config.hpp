@@ -1,6 +1,8 @@
 #pragma once
 
+#include "phoenix/enums/log_idle.hpp"
 #include "phoenix/enums/log_level.hpp"
+#include "phoenix/enums/log_overflow.hpp"
 
 #include <boost/describe/enum_from_string.hpp>
 #include <boost/describe/enum_to_string.hpp>
@@ -46,10 +48,19 @@ struct Config
                 ("aggressive", po::value<bool>(&aggressive)->default_value(aggressive), "Aggressive mode")
                 ("profiled", po::value<bool>(&profiled)->default_value(profiled), "Profiling mode")
                 ("position-limit", po::value<double>(&positionBoundary)->default_value(positionBoundary), "One sided quote position limit")
+                ("book-depth", po::value<unsigned>(&bookDepth)->default_value(bookDepth), "Levels per side in the market data subscription, past every level a ladder can take (0 for the full book)")
+                ("ladder-levels", po::value<unsigned>(&ladderLevels)->default_value(ladderLevels), "Levels per side of the ladder quoter, one tick size apart [1, 8]")
+                ("stale-threshold-us", po::value<unsigned>(&staleThresholdUs)->default_value(staleThresholdUs), "Max exchange to local latency of the book to requote on it, in microseconds (0 for none)")
                 ("log-level", po::value<LogLevel>(&logLevel)->default_value(logLevel), "Log level [DEBUG, INFO, WARN, ERROR, FATAL]")
                 ("log-print", po::value<bool>(&printLogs)->default_value(printLogs), "Print all logs")
+                ("log-overflow", po::value<LogOverflow>(&logOverflow)->default_value(logOverflow), "Logger overflow policy [DROP, DROP_VERBOSE, SPILL]")
+                ("log-idle", po::value<LogIdle>(&logIdle)->default_value(logIdle), "Logger thread idle policy [SPIN, YIELD, BACKOFF]")
+                ("log-cpu", po::value<int>(&logCpu)->default_value(logCpu), "CPU affinity index of the logger thread (< 0 for any core)")
                 ("log-folder", po::value<std::string>(&logFolder)->required(), "Path to where the log file will be saved")
                 ("colo", po::value<bool>(&colo)->default_value(colo), "Colo mode")
+                ("gateway", po::value<std::string>(&gateway)->default_value(gateway), "POSIX shared memory name of an order gateway channel to send orders through, e.g. /phoenix-gw-usd (empty for our own session)")
+                ("subaccount-username", po::value<std::vector<std::string>>(&subaccountUsernames)->multitoken(), "Deribit usernames of subaccounts to shard ladder levels across, each on a session of its own next to the main one")
+                ("subaccount-secret", po::value<std::vector<std::string>>(&subaccountSecrets)->multitoken(), "Deribit client secrets of the subaccounts, in the same order")
             ;
             // clang-format on
 
@@ -94,14 +105,25 @@ struct Config
     std::string logFolder;
     LogLevel logLevel = LogLevel::INFO;
     bool printLogs = false;
+    LogOverflow logOverflow = LogOverflow::SPILL;
+    LogIdle logIdle = LogIdle::BACKOFF;
+    int logCpu = -1;
 
     VolumeType lotSize;
     PriceType tickSize;
 
     bool aggressive = true;
     double positionBoundary = 20.0;
+    unsigned staleThresholdUs = 0u;
+    unsigned ladderLevels = 3u;
+    unsigned bookDepth = 20u;
     bool profiled = false;
     bool colo = false;
+    std::string gateway;
+
+    // order sessions of subaccounts, see SessionPool
+    std::vector<std::string> subaccountUsernames;
+    std::vector<std::string> subaccountSecrets;
 };
 
 } // namespace phoenix
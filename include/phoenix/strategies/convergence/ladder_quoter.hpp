@@ -0,0 +1,538 @@
+#pragma once
+
+#include "phoenix/common/exchange_latency.hpp"
+#include "phoenix/common/logger.hpp"
+#include "phoenix/common/scheduler.hpp"
+#include "phoenix/data/fix.hpp"
+#include "phoenix/data/order_table.hpp"
+#include "phoenix/data/orders.hpp"
+#include "phoenix/strategies/convergence/book.hpp"
+#include "phoenix/tools/tracepoints.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+
+namespace phoenix::convergence {
+
+// Quotes a ladder of ladder-levels per side one tick size apart, from one tick inside the touch outwards
+// Levels live in a flat array and are matched to the ladder by price, so an update only sends the prices that moved,
+// as new orders, in place replaces of the levels that fell off the ladder, or cancels, in one batch
+// A filled level is taken profit on at the other side of 1 like the Quoter, and requoted on a later update
+// With subaccounts in the SessionPool, the level at index i of both sides and its take profits live on session i modulo their number,
+// each session sends its own batch against its own credits, so more of the ladder moves per update
+template<typename NodeBase>
+struct LadderQuoter : NodeBase
+{
+    using NodeBase::NodeBase;
+
+    using Traits = NodeBase::Traits;
+    using PriceType = NodeBase::Traits::PriceType;
+    using VolumeType = NodeBase::Traits::VolumeType;
+    using Order = SingleOrder<Traits>;
+    using Request = OrderRequest<Traits>;
+
+    static constexpr unsigned MAX_LEVELS = 8u;
+
+    // messages per batch of a session, inside its 5 a second of throttle, the outer levels catch up on later updates
+    static constexpr std::size_t MAX_BATCH = 4u;
+
+    inline void handle(tag::Quoter::MDUpdate, Book<Traits> const& book)
+    {
+        PHOENIX_TRACE(md_update, 0u); // the one book
+        auto* handler = this->getHandler();
+        auto* config = this->getConfig();
+
+        if (handler->retrieve(tag::ExchangeLatency::IsStale{}, INSTRUMENT_STREAM))
+            return;
+
+        //////// GET PRICES
+        // levels of our own ladder aren't levels to step up against
+        PriceType const bestBid = getCompetingBid<Traits>(book, [&](PriceType price) { return getOwnVolume(bids, price); });
+        PriceType const bestAsk = getCompetingAsk<Traits>(book, [&](PriceType price) { return getOwnVolume(asks, price); });
+
+        //////// DIFF
+        PriceType const tickSize = config->tickSize;
+        unsigned const numLevels = std::clamp(config->ladderLevels, 1u, MAX_LEVELS);
+
+        // never at or through the take profit price of the other side
+        PriceType const topBid = std::min(bestBid + tickSize, TAKE_PROFIT_ASK - tickSize);
+        PriceType const topAsk = std::max(bestAsk - tickSize, TAKE_PROFIT_BID + tickSize);
+
+        std::size_t const numSessions = std::min(handler->retrieve(tag::SessionPool::GetSize{}), MAX_SESSIONS);
+        for (std::size_t i = 0u; i < numSessions; ++i)
+            batches[i].numRequests = 0u;
+
+        std::array<PriceType, MAX_LEVELS> bidTargets{};
+        std::array<PriceType, MAX_LEVELS> askTargets{};
+        std::size_t numBidTargets = 0u;
+        for (unsigned level = 0u; level < numLevels; ++level)
+        {
+            PriceType const offset = tickSize * static_cast<double>(level);
+            if (topBid > offset)
+                bidTargets[numBidTargets++] = topBid - offset;
+            askTargets[level] = topAsk + offset;
+        }
+
+        std::size_t numRequests = 0u;
+        if (bestBid)
+            numRequests += diff(1u, {bidTargets.data(), numBidTargets}, numSessions);
+        if (bestAsk)
+            numRequests += diff(2u, {askTargets.data(), numLevels}, numSessions);
+
+        if (!numRequests)
+            return;
+
+        //////// TRIGGER
+        PHOENIX_TRACE(trigger, numRequests);
+        handler->invoke(tag::FlightRecorder::Decision{}, "ladder", topBid, topAsk, numRequests);
+
+        for (std::size_t i = 0u; i < numSessions; ++i)
+        {
+            if (batches[i].numRequests)
+                send(batches[i]);
+        }
+    }
+
+    inline void handle(tag::Quoter::ExecutionReport, FIXReader& report)
+    {
+        auto* handler = this->getHandler();
+        auto* config = this->getConfig();
+
+        auto const& symbol = report.getString("55");
+        auto status = report.getNumber<unsigned>("39");
+        auto const& orderId = report.getString("11");
+        auto const& clOrderId = report.getString("41");
+        auto remaining = report.getDecimal<VolumeType>("151");
+        auto justExecuted = report.getDecimal<VolumeType>("14");
+        auto side = report.getNumber<unsigned>("54");
+        auto price = report.getDecimal<PriceType>("44");
+        PHOENIX_LOG_VERIFY(handler, (!price.error && !remaining.error), "Decimal parse error");
+
+        if (symbol != config->instrument)
+        {
+            PHOENIX_LOG_WARN(handler, "Incorrect instrument", symbol);
+            return;
+        }
+
+        // our ClOrdID comes back in 41
+        ClOrdId const clOrdId = OpenOrders::parse(clOrderId);
+        auto* record = openOrders.find(clOrdId);
+        if (!record) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "Report for an order that isn't open", orderId, clOrderId);
+            return;
+        }
+
+        bool const isTakeProfit = record->order.takeProfit;
+        auto* level = isTakeProfit ? nullptr : &(record->order.side == 1 ? bids : asks)[record->level];
+
+        switch (status)
+        {
+        case 0:
+        case 5:
+        {
+            logOrder(status ? "[REPLACED]" : "[NEW ORDER]", orderId, side, price, remaining);
+            // the level rests at what was sent from now on
+            if (level)
+            {
+                Order acked = record->order;
+                if (!acceptOrderId(handler, acked, orderId)) [[unlikely]]
+                    break;
+
+                acked.isInFlight = false;
+                acked.isActive = true;
+                *level = acked;
+                record->order = acked;
+            }
+        }
+        break;
+
+        case 1: logOrder("[PARTIAL FILL]", orderId, side, price, justExecuted); break;
+
+        case 2:
+        {
+            double const avgFillPrice = getAvgFillPrice(report);
+            logOrder("[FILL]", orderId, side, avgFillPrice, justExecuted);
+
+            if (isTakeProfit)
+            {
+                double const captured = record->order.side == 2 ? avgFillPrice - record->entry.asDouble()
+                                                                : record->entry.asDouble() - avgFillPrice;
+                edgeCaptured += captured * record->order.volume.asDouble();
+                PHOENIX_LOG_INFO(handler, "[EDGE CAPTURED]", edgeCaptured);
+            }
+            else
+            {
+                *level = emptyLevel();
+                takeProfit(record->order, PriceType{avgFillPrice});
+            }
+
+            openOrders.erase(clOrdId);
+        }
+        break;
+
+        case 4:
+        {
+            logOrder("[CANCELLED]", orderId, side, price, remaining);
+
+            // take profits are never given up, a cancelled level is requoted by the next update
+            if (isTakeProfit)
+                sendTakeProfit(record->order, record->entry, "[RETRYING TAKE PROFIT]");
+            else
+                *level = emptyLevel();
+
+            openOrders.erase(clOrdId);
+        }
+        break;
+
+        case 8:
+        {
+            auto reason = report.getStringView("103");
+            logOrder("[REJECTED]", orderId, side, price, remaining, reason);
+            if (level)
+                *level = emptyLevel();
+
+            openOrders.erase(clOrdId);
+        }
+        break;
+
+        default: PHOENIX_LOG_WARN(handler, "Other status type", status); break;
+        }
+    }
+
+    // A rejected replace leaves the last acknowledged level resting
+    inline void handle(tag::Quoter::CancelReject, FIXReader& reject)
+    {
+        auto* handler = this->getHandler();
+        auto const& clOrderId = reject.getString("11");
+        auto* record = openOrders.find(clOrderId);
+        if (!record || record->order.takeProfit)
+        {
+            PHOENIX_LOG_WARN(handler, "Cancel reject for an order that isn't a level", clOrderId);
+            return;
+        }
+
+        // the level still has what was last acknowledged
+        auto& level = (record->order.side == 1 ? bids : asks)[record->level];
+        level.isInFlight = false;
+        record->order = level;
+        PHOENIX_LOG_WARN(handler, "[CANCEL REJECTED]", level.orderId.view(), "with reason", reject.getStringView("58"));
+    }
+
+private:
+    struct Record
+    {
+        Order order;         // as last sent, the level keeps what was last acknowledged until the ack
+        std::uint32_t level; // index in bids or asks
+        PriceType entry;     // fill price a take profit closes
+    };
+
+    // the requests of one session in the current update
+    struct Batch
+    {
+        std::array<Order, MAX_BATCH> pendingOrders{};
+        std::array<std::uint32_t, MAX_BATCH> pendingLevels{};
+        std::array<Request, MAX_BATCH> requests{};
+        std::size_t numRequests = 0u;
+    };
+
+    static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+    static constexpr std::size_t MAX_OPEN_ORDERS = 64u;
+    using OpenOrders = OrderTable<Record, MAX_OPEN_ORDERS>;
+
+    static VolumeType getOwnVolume(std::array<Order, MAX_LEVELS> const& levels, PriceType price)
+    {
+        for (auto const& level : levels)
+        {
+            if (level.isActive && level.price == price)
+                return level.volume;
+        }
+
+        return {};
+    }
+
+    static Order emptyLevel()
+    {
+        // clang-format off
+        return {
+            .symbol = {},
+            .price = {},
+            .volume = {},
+            .side = 0u,
+            .isActive = false,
+            .isInFlight = false
+        };
+        // clang-format on
+    }
+
+    static std::array<Order, MAX_LEVELS> emptyLevels()
+    {
+        std::array<Order, MAX_LEVELS> levels;
+        levels.fill(emptyLevel());
+        return levels;
+    }
+
+    // matches the target prices of a side against its levels by price, a level at or headed to a target stays where it is
+    // targets left over are taken by levels at no target as replaces, then by empty levels as new orders,
+    // and the levels still at no target are cancelled, so a one tick shift moves only the far level
+    // returns the requests queued, a full batch leaves the rest for a later update
+    inline std::size_t diff(unsigned side, std::span<PriceType const> targets, std::size_t numSessions)
+    {
+        auto const& levels = side == 1 ? bids : asks;
+        auto const hasRoom = [&](std::uint32_t index) { return batches[index % numSessions].numRequests < MAX_BATCH; };
+
+        // levels at no target, and levels given a request in this update
+        std::array<bool, MAX_LEVELS> isCovered{};
+        std::array<bool, MAX_LEVELS> isStray{};
+        std::array<bool, MAX_LEVELS> isTaken{};
+        for (std::uint32_t index = 0u; index < MAX_LEVELS; ++index)
+        {
+            auto const& level = levels[index];
+            if (!level.isActive && !level.isInFlight)
+                continue;
+
+            auto const target = std::find(targets.begin(), targets.end(), getSentPrice(level));
+            std::size_t const k = static_cast<std::size_t>(target - targets.begin());
+            if (target != targets.end() && !isCovered[k])
+                isCovered[k] = true;
+            else
+                isStray[index] = true;
+        }
+
+        std::size_t numRequests = 0u;
+        for (std::size_t k = 0u; k < targets.size(); ++k)
+        {
+            if (isCovered[k])
+                continue;
+
+            std::uint32_t index = findLevel([&](std::uint32_t i) {
+                return isStray[i] && !isTaken[i] && !levels[i].isInFlight && hasRoom(i);
+            });
+            OrderAction action = OrderAction::REPLACE;
+            if (index == NONE)
+            {
+                index = findLevel([&](std::uint32_t i) {
+                    return !levels[i].isActive && !levels[i].isInFlight && !isTaken[i] && hasRoom(i);
+                });
+                action = OrderAction::NEW;
+            }
+
+            if (index == NONE || !queue(batches[index % numSessions], action, side, index, targets[k]))
+                continue;
+
+            isTaken[index] = true;
+            ++numRequests;
+        }
+
+        for (std::uint32_t index = 0u; index < MAX_LEVELS; ++index)
+        {
+            if (!isStray[index] || isTaken[index] || levels[index].isInFlight || !hasRoom(index))
+                continue;
+
+            if (queue(batches[index % numSessions], OrderAction::CANCEL, side, index, levels[index].price))
+                ++numRequests;
+        }
+
+        return numRequests;
+    }
+
+    // first level index that fits, NONE without one
+    template<typename Predicate>
+    static std::uint32_t findLevel(Predicate&& fits)
+    {
+        for (std::uint32_t index = 0u; index < MAX_LEVELS; ++index)
+        {
+            if (fits(index))
+                return index;
+        }
+
+        return NONE;
+    }
+
+    // where the exchange will have a level, what was last sent for it while in flight
+    inline PriceType getSentPrice(Order const& level)
+    {
+        if (!level.isInFlight)
+            return level.price;
+
+        auto const* record = openOrders.find(level.clOrdId);
+        return record ? record->order.price : level.price;
+    }
+
+    // a new order for an empty level, a replace or a cancel of a resting one, true when queued
+    inline bool queue(Batch& batch, OrderAction action, unsigned side, std::uint32_t index, PriceType target)
+    {
+        auto const& level = (side == 1 ? bids : asks)[index];
+        auto* config = this->getConfig();
+        auto& pending = batch.pendingOrders[batch.numRequests];
+
+        if (action == OrderAction::NEW)
+        {
+            // clang-format off
+            pending = {
+                .symbol = config->instrument,
+                .price = target,
+                .volume = config->lotSize,
+                .side = side,
+                .session = static_cast<std::uint8_t>(&batch - batches.data())
+            };
+            // clang-format on
+
+            pending.clOrdId = openOrders.insert({.order = pending, .level = index, .entry = {}});
+            if (!pending.clOrdId) [[unlikely]]
+            {
+                PHOENIX_LOG_WARN(this->getHandler(), "No room for another open order, level", index, "skipped");
+                return false;
+            }
+        }
+        else
+        {
+            pending = level;
+            pending.price = target;
+            if (action == OrderAction::REPLACE)
+                pending.volume = config->lotSize;
+        }
+
+        pending.isInFlight = true;
+        batch.requests[batch.numRequests] = {action, &pending};
+        batch.pendingLevels[batch.numRequests] = index;
+        ++batch.numRequests;
+        return true;
+    }
+
+    // on the session of the batch, a batch its session has no credits for, or behind orders in the Scheduler, is given up until a later update
+    // a sent level only moves on its ack, until then our own volume is where the exchange still has it
+    inline void send(Batch& batch)
+    {
+        auto* handler = this->getHandler();
+        bool const sent = handler->retrieve(tag::Stream::SendBatch{}, std::span<Request const>{batch.requests.data(), batch.numRequests});
+        for (std::size_t i = 0u; i < batch.numRequests; ++i)
+        {
+            auto const& pending = batch.pendingOrders[i];
+            auto& level = (pending.side == 1 ? bids : asks)[batch.pendingLevels[i]];
+            if (!sent)
+            {
+                if (batch.requests[i].action == OrderAction::NEW)
+                    openOrders.erase(pending.clOrdId);
+                continue;
+            }
+
+            // a new level is found by its ClOrdID until the ack
+            level.isInFlight = true;
+            level.clOrdId = pending.clOrdId;
+            openOrders.find(pending.clOrdId)->order = pending;
+            PHOENIX_LOG_INFO(
+                handler,
+                getLabel(batch.requests[i].action),
+                pending.side == 1 ? "BID" : "ASK",
+                batch.pendingLevels[i],
+                pending.volume.asDouble(),
+                '@',
+                pending.price.asDouble(),
+                "session",
+                static_cast<unsigned>(pending.session));
+        }
+    }
+
+    static std::string_view getLabel(OrderAction action)
+    {
+        switch (action)
+        {
+        case OrderAction::NEW: return "[QUOTED]";
+        case OrderAction::REPLACE: return "[REPLACING]";
+        case OrderAction::CANCEL: return "[CANCELLING]";
+        }
+
+        return {};
+    }
+
+    // closes a filled level at the take profit price of the other side
+    void takeProfit(Order const& filled, PriceType entry)
+    {
+        // clang-format off
+        sendTakeProfit({
+            .symbol = filled.symbol,
+            .price = filled.side == 1 ? TAKE_PROFIT_ASK : TAKE_PROFIT_BID,
+            .volume = filled.volume,
+            .side = filled.side == 1 ? 2u : 1u,
+            .takeProfit = true,
+            .session = filled.session
+        }, entry, "[TAKE PROFIT]");
+        // clang-format on
+    }
+
+    // under a fresh ClOrdID, queued ahead of quotes until it goes out
+    void sendTakeProfit(Order order, PriceType entry, std::string_view label)
+    {
+        auto* handler = this->getHandler();
+        order.clOrdId = openOrders.insert({.order = order, .level = 0u, .entry = entry});
+        PHOENIX_LOG_VERIFY(handler, (order.clOrdId), "No room for a take profit order");
+
+        bool const isAccepted = handler->retrieve(tag::Scheduler::Submit{}, Priority::HEDGE, OrderAction::NEW, order).isAccepted;
+        PHOENIX_LOG_VERIFY(handler, (isAccepted), "No room to queue a take profit order");
+        PHOENIX_LOG_INFO(
+            handler,
+            label,
+            order.side == 1 ? "BID" : "ASK",
+            order.volume.asDouble(),
+            '@',
+            order.price.asDouble());
+    }
+
+    static inline double getAvgFillPrice(FIXReader& report)
+    {
+        unsigned const numFills = report.getNumber<unsigned>("1362");
+        double avgFillPrice = 0.0;
+        double totalQty = 0.0;
+        for (unsigned i = 0u; i < numFills; ++i)
+        {
+            double const fillQty = report.getNumber<double>("1365", i);
+            double const fillPrice = report.getNumber<double>("1364", i);
+            totalQty += fillQty;
+            avgFillPrice += (fillQty * fillPrice);
+        }
+        if (totalQty && avgFillPrice)
+            avgFillPrice /= totalQty;
+
+        return avgFillPrice;
+    }
+
+    inline void logOrder(
+        std::string_view type,
+        std::string_view orderId,
+        unsigned side,
+        PriceType price,
+        VolumeType volume,
+        std::string_view rejectReason = "")
+    {
+        PHOENIX_LOG_INFO(
+            this->getHandler(),
+            type,
+            orderId,
+            side == 1 ? "BUY" : "SELL",
+            volume.asDouble(),
+            '@',
+            price.asDouble(),
+            rejectReason.empty() ? "" : "with reason",
+            rejectReason);
+    }
+
+    static constexpr PriceType TAKE_PROFIT_BID{1.0001};
+    static constexpr PriceType TAKE_PROFIT_ASK{0.9999};
+
+    // inactive levels are empty
+    std::array<Order, MAX_LEVELS> bids = emptyLevels();
+    std::array<Order, MAX_LEVELS> asks = emptyLevels();
+
+    // per session, the batches of the current update
+    std::array<Batch, MAX_SESSIONS> batches{};
+
+    OpenOrders openOrders;
+    double edgeCaptured = 0.0;
+};
+
+} // namespace phoenix::convergence
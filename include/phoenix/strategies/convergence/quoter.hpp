@@ -1,8 +1,12 @@
 #pragma once
 
+#include "phoenix/common/exchange_latency.hpp"
 #include "phoenix/common/logger.hpp"
+#include "phoenix/common/scheduler.hpp"
 #include "phoenix/data/fix.hpp"
 #include "phoenix/data/orders.hpp"
+#include "phoenix/strategies/convergence/book.hpp"
+#include "phoenix/tools/tracepoints.hpp"
 
 #include <boost/unordered/unordered_flat_map.hpp>
 #include <boost/unordered/unordered_flat_set.hpp>
@@ -25,24 +29,20 @@ struct Quoter : NodeBase
     using PriceValue = PriceType::ValueType;
     using Order = SingleOrder<Traits>;
 
-    inline void handle(tag::Quoter::MDUpdate, FIXReader& marketData)
+    inline void handle(tag::Quoter::MDUpdate, Book<Traits> const& book)
     {
+        PHOENIX_TRACE(md_update, 0u); // the one book
         auto* handler = this->getHandler();        
         auto* config = this->getConfig();
 
-        //////// GET PRICES
-        PriceType bestBid;
-        PriceType bestAsk;
+        // the exchange may already have moved past a late update, the next timely one requotes
+        if (handler->retrieve(tag::ExchangeLatency::IsStale{}, INSTRUMENT_STREAM))
+            return;
 
-        std::size_t const numUpdates = marketData.getNumber<std::size_t>("268");
-        for (std::size_t i = 0u; i < numUpdates; ++i)
-        {
-            unsigned const typeField = marketData.getNumber<unsigned>("269", i);
-            if (typeField == 0u)
-                bestBid.minOrZero(marketData.getDecimal<PriceType>("270", i));
-            if (typeField == 1u)
-                bestAsk.minOrZero(marketData.getDecimal<PriceType>("270", i));
-        }
+        //////// GET PRICES
+        // our own resting quote isn't a level to step up against
+        PriceType const bestBid = getCompetingBid<Traits>(book, [&](PriceType price) { return getOwnVolume(lastBid, price); });
+        PriceType const bestAsk = getCompetingAsk<Traits>(book, [&](PriceType price) { return getOwnVolume(lastAsk, price); });
 
         //////// TRIGGER
         PriceType const tickSize = config->tickSize;
@@ -50,11 +50,16 @@ struct Quoter : NodeBase
 
         if (bestBid)
         {
+            // a resting quote is amended in place, one message against the rate limit and no gap in the book
+            // so is a quote still waiting in the Scheduler, the newer one takes its place before it goes out
+            if (lastBid.isActive && (!lastBid.isInFlight || isQueued(lastBid)) && lastBid.price < bestBid && bestBid < TAKE_PROFIT_ASK - 0.0001)
+                replaceQuote(lastBid, bestBid + 0.0001, lotSize);
+
             if (lastBid.price < bestBid && !lastBid.isInFlight && lastBid.price)
             {
                 lastBid.isActive = false;
-                while (!handler->retrieve(tag::Stream::CancelQuote{}, lastBid.orderId));
-                PHOENIX_LOG_INFO(handler, "Cancelling stale order", lastBid.orderId);
+                submit(Priority::CANCEL, OrderAction::CANCEL, lastBid, lastBid.clOrdId);
+                PHOENIX_LOG_INFO(handler, "Cancelling stale order", lastBid.orderId.view());
             }
 
             if (lastBid.price < bestBid && bestBid < TAKE_PROFIT_ASK - 0.0001)
@@ -70,11 +75,14 @@ struct Quoter : NodeBase
 
         if (bestAsk)
         {
+            if (lastAsk.isActive && (!lastAsk.isInFlight || isQueued(lastAsk)) && lastAsk.price > bestAsk && bestAsk > TAKE_PROFIT_BID + 0.0001)
+                replaceQuote(lastAsk, bestAsk - 0.0001, lotSize);
+
             if (lastAsk.price > bestAsk && !lastAsk.isInFlight && lastAsk.price)
             {
                 lastAsk.isActive = false;
-                while (!handler->retrieve(tag::Stream::CancelQuote{}, lastAsk.orderId));
-                PHOENIX_LOG_INFO(handler, "Cancelling stale order", lastAsk.orderId);
+                submit(Priority::CANCEL, OrderAction::CANCEL, lastAsk, lastAsk.clOrdId);
+                PHOENIX_LOG_INFO(handler, "Cancelling stale order", lastAsk.orderId.view());
             }
 
             if (lastAsk.price > bestAsk && bestAsk > TAKE_PROFIT_BID + 0.0001)
@@ -104,14 +112,27 @@ struct Quoter : NodeBase
         auto price = report.getDecimal<PriceType>("44");
         PHOENIX_LOG_VERIFY(handler, (!price.error && !remaining.error), "Decimal parse error");
 
-        bool const isTakeProfit = clOrderId.size() == 0 || clOrderId[0] == 't';
-        auto& sentOrder = side == 1 ? lastBid : lastAsk;
-
         if (symbol != config->instrument)
         {
             PHOENIX_LOG_WARN(handler, "Incorrect instrument", symbol);
             return;
         }
+
+        // our ClOrdID comes back in 41
+        ClOrdId const clOrdId = OpenOrders::parse(clOrderId);
+        auto* record = openOrders.find(clOrdId);
+        if (!record) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "Report for an order that isn't open", orderId, clOrderId);
+            return;
+        }
+
+        bool const isTakeProfit = record->takeProfit;
+        auto& sentOrder = side == 1 ? lastBid : lastAsk;
+
+        // filled, cancelled and rejected orders are done, a partial fill stays open
+        if (status == 2u || status == 4u || status == 8u)
+            openOrders.erase(clOrdId);
          
         switch (status)
         {
@@ -120,7 +141,9 @@ struct Quoter : NodeBase
             logOrder("[NEW ORDER]", orderId, side, price, remaining); 
             if (!isTakeProfit)
             {
-                sentOrder.orderId = orderId;
+                if (!acceptOrderId(handler, sentOrder, orderId)) [[unlikely]]
+                    break;
+
                 sentOrder.isInFlight = false;
                 sentOrder.isActive = true;
             }
@@ -128,6 +151,17 @@ struct Quoter : NodeBase
         break;
         
         case 1: logOrder("[PARTIAL FILL]", orderId, side, price, justExecuted); break;
+
+        case 5:
+        {
+            logOrder("[REPLACED]", orderId, side, price, remaining);
+            if (!acceptOrderId(handler, sentOrder, orderId)) [[unlikely]]
+                break;
+
+            sentOrder.isInFlight = false;
+            *record = sentOrder;
+        }
+        break;
         
         case 2:
         {
@@ -196,28 +230,121 @@ struct Quoter : NodeBase
         }
     }
 
+    // A rejected replace leaves the last acknowledged quote resting
+    inline void handle(tag::Quoter::CancelReject, FIXReader& reject)
+    {
+        auto* handler = this->getHandler();
+        auto const& clOrderId = reject.getString("11");
+        auto const* record = openOrders.find(clOrderId);
+        if (!record)
+        {
+            PHOENIX_LOG_WARN(handler, "Cancel reject for an order that isn't open", clOrderId);
+            return;
+        }
+
+        auto& order = record->side == 1 ? lastBid : lastAsk;
+        order.price = record->price;
+        order.volume = record->volume;
+        order.isInFlight = false;
+        PHOENIX_LOG_WARN(handler, "[CANCEL REJECTED]", order.orderId.view(), "with reason", reject.getStringView("58"));
+    }
+
 private:
-    void sendQuote(SingleOrder<Traits> const& quote, bool isNormal = true)
+    static VolumeType getOwnVolume(Order const& order, PriceType price)
+    {
+        return order.isActive && order.price == price ? order.volume : VolumeType{};
+    }
+
+    // released by the Scheduler as the credits allow, an order it supersedes never reaches the exchange
+    bool submit(Priority priority, OrderAction action, Order const& order, std::uint64_t key = 0u)
+    {
+        auto const [isAccepted, superseded] =
+            this->getHandler()->retrieve(tag::Scheduler::Submit{}, priority, action, order, key);
+
+        if (superseded && superseded != order.clOrdId)
+            openOrders.erase(superseded);
+
+        return isAccepted;
+    }
+
+    // still in the Scheduler under its side key, sent orders are in flight until their ack
+    [[gnu::hot, gnu::always_inline]]
+    inline bool isQueued(Order const& quote)
+    {
+        return quote.isInFlight && this->getHandler()->retrieve(tag::Scheduler::IsQueued{}, Priority::QUOTE, quote.side);
+    }
+
+    // price and size of a resting quote, the table keeps the acknowledged quote until the exchange confirms
+    // a new quote that never went out is still a new order, only at the newer price
+    void replaceQuote(Order& order, PriceType price, VolumeType volume)
     {
         auto* handler = this->getHandler();
+        PHOENIX_TRACE(trigger, order.side);
+        handler->invoke(tag::FlightRecorder::Decision{}, order.side == 1 ? "replace bid" : "replace ask", price, volume);
+
+        Order replacement = order;
+        replacement.price = price;
+        replacement.volume = volume;
+        OrderAction const action = order.orderId.empty() ? OrderAction::NEW : OrderAction::REPLACE;
+        if (!submit(Priority::QUOTE, action, replacement, replacement.side))
+            return;
+
+        if (action == OrderAction::NEW)
+        {
+            if (auto* record = openOrders.find(replacement.clOrdId))
+                *record = replacement;
+        }
+
+        order = replacement;
+        order.isInFlight = true;
 
+        PHOENIX_LOG_INFO(
+            handler,
+            action == OrderAction::NEW ? "[REQUOTING]" : "[REPLACING]",
+            order.orderId.view(),
+            order.side == 1 ? "BID" : "ASK",
+            volume.asDouble(),
+            '@',
+            price.asDouble());
+    }
+
+    void sendQuote(SingleOrder<Traits> const& newQuote, bool isNormal = true)
+    {
+        auto* handler = this->getHandler();
+        PHOENIX_TRACE(trigger, newQuote.side);
+        handler->invoke(tag::FlightRecorder::Decision{}, newQuote.side == 1 ? "quote bid" : "quote ask", newQuote.price, newQuote.volume);
+
+        // a new quote still in the Scheduler is superseded by this one, anything sent waits for its ack
+        auto const& lastQuote = newQuote.side == 1 ? lastBid : lastAsk;
+        if (isNormal && lastQuote.isInFlight && !(lastQuote.orderId.empty() && isQueued(lastQuote))) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "[IN-FLIGHT] Quote request ignored due to in-flight quote");
+            return;
+        }
+
+        Order quote = newQuote;
+        quote.clOrdId = openOrders.insert(quote);
+        if (!quote.clOrdId) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "No room for another open order, quote ignored");
+            return;
+        }
+
+        // a quote supersedes a queued one of its side, a take profit is never dropped
         if (isNormal)
         {
-            auto& order = quote.side == 1 ? lastBid : lastAsk;
-            if (order.isInFlight) [[unlikely]]
+            if (submit(Priority::QUOTE, OrderAction::NEW, quote, quote.side))
+                (quote.side == 1 ? lastBid : lastAsk) = quote;
+            else
             {
-                PHOENIX_LOG_WARN(handler, "[IN-FLIGHT] Quote request ignored due to in-flight quote");
+                openOrders.erase(quote.clOrdId);
                 return;
             }
-
-            if (handler->retrieve(tag::Stream::SendQuotes{}, quote))
-                order = quote;
-            else 
-                return;
         }
         else 
         {
-            while (!handler->retrieve(tag::Stream::SendQuotes{}, quote));
+            bool const isAccepted = submit(Priority::HEDGE, OrderAction::NEW, quote);
+            PHOENIX_LOG_VERIFY(handler, (isAccepted), "No room to queue a take profit order");
         }
         
         PHOENIX_LOG_INFO(
@@ -255,7 +382,7 @@ private:
     static constexpr VolumeType TAKE_PROFIT_ASK{0.9999};
 
     Order lastBid{.side = 1, .isActive = false, .isInFlight = false};
-    Order lastAsk{.side = 1, .isActive = false, .isInFlight = false};
+    Order lastAsk{.side = 2, .isActive = false, .isInFlight = false};
     Order lastBidTP{.price = TAKE_PROFIT_BID, .side = 1, .takeProfit = true};
     Order lastAskTP{.price = TAKE_PROFIT_ASK, .side = 2, .takeProfit = true};
 
@@ -266,6 +393,11 @@ private:
     double totalAskNum = 0.0;
 
     PriceType edgeCaptured{0.0};
+
+    // every quote and take profit order until its fill, cancel or reject
+    static constexpr std::size_t MAX_OPEN_ORDERS = 64u;
+    using OpenOrders = OrderTable<Order, MAX_OPEN_ORDERS>;
+    OpenOrders openOrders;
 };
 
 /*
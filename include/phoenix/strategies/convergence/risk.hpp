@@ -26,6 +26,9 @@ private:
     {
         if (aborted.test())
         {
+            this->getHandler()->invoke(tag::FlightRecorder::Dump{}, "Risk::Abort");
+            this->getHandler()->invoke(tag::ExchangeLatency::Report{});
+
             // cancel on disconnect is enabled on login
             this->getHandler()->invoke(tag::Stream::Stop{});
             this->getHandler()->invoke(tag::Logger::Stop{});
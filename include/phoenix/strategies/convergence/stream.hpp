@@ -1,10 +1,13 @@
 #pragma once
 
+#include "phoenix/common/exchange_latency.hpp"
 #include "phoenix/common/logger.hpp"
 #include "phoenix/common/profiler.hpp"
 #include "phoenix/data/fix.hpp"
 #include "phoenix/data/orders.hpp"
+#include "phoenix/strategies/convergence/book.hpp"
 #include "phoenix/tools/fix_circular_buffer.hpp"
+#include "phoenix/tools/tracepoints.hpp"
 #include "phoenix/tags.hpp"
 
 #include <boost/asio.hpp>
@@ -13,7 +16,11 @@
 #include <chrono>
 #include <cstdint>
 #include <exception>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <immintrin.h>
@@ -32,38 +39,59 @@ struct Stream : NodeBase
     Stream(auto const& config, auto& handler)
         : NodeBase{config, handler}
         , fixBuilder(config.client)
+        , book{config.tickSize}
     {}
 
     void handle(tag::Stream::Stop)
     {
         auto logoutMsg = fixBuilder.logout(nextSeqNum);
         isRunning = false;
+        this->getHandler()->invoke(tag::SessionPool::Stop{});
         this->getHandler()->invoke(tag::TCPSocket::Stop{}, logoutMsg);
     }
 
     void handle(tag::Stream::Start)
     {
+        auto* handler = this->getHandler();
         auto* config = this->getConfig();
-        this->getHandler()->invoke(tag::TCPSocket::Connect{}, config->host, config->port, config->colo); 
+        handler->invoke(tag::Gateway::Start{});
+        isGateway = handler->retrieve(tag::Gateway::IsEnabled{});
+
+        handler->invoke(tag::TCPSocket::Connect{}, config->host, config->port, config->colo); 
         login();
+
+        // the gateway has a session of its own for the orders
+        if (!isGateway)
+            handler->invoke(tag::SessionPool::Start{});
+
+        isPooled = handler->retrieve(tag::SessionPool::GetSize{}) > 1u;
         isRunning = true;
 
         startPipeline();
     }
     
-    inline bool handle(tag::Stream::SendQuotes, SingleOrder<Traits> const& quote)
+    // a message of the Scheduler, false without the credits of its session for it, or while the gateway holds it back
+    [[gnu::hot, gnu::always_inline]]
+    inline bool handle(tag::Stream::Release, Priority priority, OrderAction action, SingleOrder<Traits> const& order)
     {
-        auto msg = fixBuilder.newOrderSingle(nextSeqNum, quote.symbol, quote);
-        bool const success = this->getHandler()->retrieve(tag::TCPSocket::Send{}, msg);
-        if (success) [[likely]]
-            ++nextSeqNum;
+        auto* handler = this->getHandler();
+        if (isGateway)
+            return handler->retrieve(tag::Gateway::Submit{}, priority, action, order);
 
-        return success;
+        if (order.session)
+            return handler->retrieve(tag::SessionPool::Send{}, action, order);
+
+        if (!handler->retrieve(tag::TCPSocket::CheckThrottle{}, 1u))
+            return false;
+
+        handler->invoke(tag::TCPSocket::SendUnthrottled{}, encode(action, order));
+        return true;
     }
 
-    inline bool handle(tag::Stream::CancelQuote, std::string_view orderId)
+    // a reply to a TestRequest with its TestReqID
+    inline bool handle(tag::Stream::SendHeartbeat, std::string_view testReqId)
     {
-        auto msg = fixBuilder.orderCancelRequest(nextSeqNum, this->getConfig()->instrument, orderId);
+        auto msg = testReqId.empty() ? fixBuilder.heartbeat(nextSeqNum) : fixBuilder.heartbeat(nextSeqNum, testReqId);
         bool const success = this->getHandler()->retrieve(tag::TCPSocket::Send{}, msg);
         if (success) [[likely]]
             ++nextSeqNum;
@@ -71,7 +99,48 @@ struct Stream : NodeBase
         return success;
     }
 
+    // Every request or none, encoded back to back and written to the socket of their session at once
+    // a batch is of quotes of one session, none goes out while the Scheduler still holds cancels, take profits or quotes of it
+    inline bool handle(tag::Stream::SendBatch, std::span<OrderRequest<Traits> const> requests)
+    {
+        auto* handler = this->getHandler();
+        if (handler->retrieve(tag::Scheduler::HasQueued{}, Priority::QUOTE, requests.front().order->session))
+            return false;
+
+        if (isGateway)
+            return handler->retrieve(tag::Gateway::SubmitBatch{}, Priority::QUOTE, requests);
+
+        if (requests.front().order->session)
+            return handler->retrieve(tag::SessionPool::SendBatch{}, requests);
+
+        if (!handler->retrieve(tag::TCPSocket::CheckThrottle{}, requests.size()))
+            return false;
+
+        batch.clear();
+        for (auto const& [action, order] : requests)
+            batch.add(encode(action, *order));
+
+        handler->invoke(tag::TCPSocket::SendUnthrottled{}, batch.view());
+        return true;
+    }
+
 private:
+    // under the next sequence number
+    [[gnu::hot, gnu::always_inline]]
+    inline std::string_view encode(OrderAction action, SingleOrder<Traits> const& order)
+    {
+        std::string_view msg;
+        switch (action)
+        {
+        case OrderAction::NEW: msg = fixBuilder.newOrderSingle(nextSeqNum, order.symbol, order); break;
+        case OrderAction::REPLACE: msg = fixBuilder.orderCancelReplaceRequest(nextSeqNum, order.symbol, order); break;
+        case OrderAction::CANCEL: msg = fixBuilder.orderCancelRequest(nextSeqNum, order.symbol, order.orderId, order.clOrdId); break;
+        }
+
+        ++nextSeqNum;
+        return msg;
+    }
+
     void startPipeline()
     {
         auto* handler = this->getHandler();
@@ -79,6 +148,7 @@ private:
         PHOENIX_LOG_INFO(handler, "Starting trading pipeline");
 
         auto& instrument = config->instrument;
+        handler->invoke(tag::ExchangeLatency::Name{}, INSTRUMENT_STREAM, instrument);
         subscribeToOne(instrument);
         
         while (isRunning)
@@ -87,47 +157,36 @@ private:
             {
                 if (std::chrono::steady_clock::now() - heartbeatLastSent > HEARTBEAT_INTERVAL) [[unlikely]]
                 {
-                    auto msg = fixBuilder.heartbeat(nextSeqNum);
-                    handler->invoke(tag::TCPSocket::ForceSend{}, msg);
-                    ++nextSeqNum;
+                    handler->invoke(tag::Scheduler::Heartbeat{});
+                    handler->invoke(tag::SessionPool::Heartbeat{});
                     heartbeatLastSent = std::chrono::steady_clock::now();
+                    handler->invoke(tag::ExchangeLatency::Report{});
                 }
 
-                auto msgOpt = handler->retrieve(tag::TCPSocket::Receive{});
-                if (!msgOpt)
-                    continue;
-
-                FIXReader reader{*msgOpt};
-                auto const& msgType = reader.getMessageType();
+                // receiving blocks, so while messages wait for credits, or reports may come from the gateway or
+                // the subaccounts, only what has already arrived is read
+                handler->invoke(tag::Scheduler::Tick{});
+                if (isGateway)
+                {
+                    while (auto report = handler->retrieve(tag::Gateway::Receive{}))
+                        process(*report);
+                }
 
-                // test request
-                if (msgType == "1")
+                if (isPooled)
                 {
-                    auto msg = fixBuilder.heartbeat(nextSeqNum, reader.getStringView("112"));
-                    handler->invoke(tag::TCPSocket::ForceSend{}, msg);
-                    ++nextSeqNum;
-                    PHOENIX_LOG_INFO(handler, "Received TestRequest, sending Heartbeat");
-                    continue;
+                    while (auto report = handler->retrieve(tag::SessionPool::Receive{}))
+                        process(*report);
                 }
 
-                auto const& recvInstrument = reader.getString("55");
-                if (instrument != recvInstrument)
+                bool const mustPoll = isGateway || isPooled || handler->retrieve(tag::Scheduler::GetQueued{});
+                if (mustPoll && !handler->retrieve(tag::TCPSocket::Available{}))
                     continue;
 
-                if (msgType == "X" or msgType == "W") [[likely]]
-                {
-                    handler->invoke(tag::Quoter::MDUpdate{}, reader);
-                    continue;
-                }
-                else if (msgType == "8")
-                {
-                    handler->invoke(tag::Quoter::ExecutionReport{}, reader);
+                auto msgOpt = handler->retrieve(tag::TCPSocket::Receive{});
+                if (!msgOpt)
                     continue;
-                }
-                else
-                {
-                    PHOENIX_LOG_INFO(handler, "Unknown message type");
-                }
+
+                process(*msgOpt);
             }
             catch (std::exception const& e)
             {
@@ -137,9 +196,74 @@ private:
         }
     }
 
+    // one message of our session, a report relayed by the gateway or one of a subaccount
+    [[gnu::hot, gnu::always_inline]]
+    inline void process(std::string_view msg)
+    {
+        auto* handler = this->getHandler();
+        auto const& instrument = this->getConfig()->instrument;
+
+        mdReader.init(msg);
+        auto const msgType = mdReader.getMessageType();
+        PHOENIX_TRACE(parse, msg.size());
+
+        // market data keeps the book and the quoters read the true best levels from it
+        if (msgType == "X" or msgType == "W") [[likely]]
+        {
+            if (mdReader.getStringView(55) != instrument)
+                return;
+
+            handler->retrieve(tag::ExchangeLatency::Record{}, INSTRUMENT_STREAM, mdReader.getStringView(52));
+            if (msgType == "W")
+                book.fromSnapshot(mdReader);
+            else
+                book.fromUpdate(mdReader);
+
+            handler->invoke(tag::Quoter::MDUpdate{}, std::as_const(book));
+            return;
+        }
+
+        // heartbeat
+        if (msgType == "0")
+            return;
+
+        // the rest is rare, and read by string tags
+        FIXReader reader{msg};
+
+        // test request
+        if (msgType == "1")
+        {
+            handler->invoke(tag::Scheduler::Heartbeat{}, reader.getStringView("112"));
+            PHOENIX_LOG_INFO(handler, "Received TestRequest, Heartbeat scheduled");
+            return;
+        }
+
+        // a cancel reject doesn't carry the instrument
+        if (msgType == "9")
+        {
+            handler->invoke(tag::Quoter::CancelReject{}, reader);
+            return;
+        }
+
+        auto const& recvInstrument = reader.getString("55");
+        if (instrument != recvInstrument)
+            return;
+
+        if (msgType == "8")
+        {
+            PHOENIX_TRACE(exec_report, msg.data(), msg.size());
+            handler->retrieve(tag::ExchangeLatency::Record{}, EXECUTION_REPORT_STREAM, reader.getStringView("52"));
+            handler->invoke(tag::Quoter::ExecutionReport{}, reader);
+        }
+        else
+        {
+            PHOENIX_LOG_INFO(handler, "Unknown message type");
+        }
+    }
+
     void subscribeToOne(std::string_view instrument)
     {
-        std::string_view const msg = fixBuilder.marketDataRefreshSingle(nextSeqNum, instrument);
+        std::string_view const msg = fixBuilder.marketDataRefreshSingle(nextSeqNum, instrument, this->getConfig()->bookDepth);
         this->getHandler()->invoke(tag::TCPSocket::ForceSend{}, msg);
         ++nextSeqNum;
     }
@@ -160,8 +284,13 @@ private:
     }
     
     bool isRunning = false;
+    bool isGateway = false;
+    bool isPooled = false;
     std::size_t nextSeqNum = 1u;
     FIXMessageBuilder fixBuilder;
+    FIXBatch batch;
+    FIXReaderFast mdReader;
+    Book<Traits> book;
     static constexpr std::chrono::seconds HEARTBEAT_INTERVAL{80u};
     std::chrono::steady_clock::time_point heartbeatLastSent = std::chrono::steady_clock::now();
 };
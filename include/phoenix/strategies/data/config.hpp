@@ -1,5 +1,9 @@
 #pragma once
 
+#include "phoenix/enums/log_idle.hpp"
+#include "phoenix/enums/log_level.hpp"
+#include "phoenix/enums/log_overflow.hpp"
+
 #include <boost/describe/enum_from_string.hpp>
 #include <boost/describe/enum_to_string.hpp>
 #include <boost/program_options.hpp>
@@ -39,6 +43,9 @@ struct Config
                 // logging
                 ("log-level", po::value<LogLevel>(&logLevel)->default_value(logLevel), "Log level [DEBUG, INFO, WARN, ERROR, FATAL]")
                 ("log-print", po::value<bool>(&printLogs)->default_value(printLogs), "Print all logs")
+                ("log-overflow", po::value<LogOverflow>(&logOverflow)->default_value(logOverflow), "Logger overflow policy [DROP, DROP_VERBOSE, SPILL]")
+                ("log-idle", po::value<LogIdle>(&logIdle)->default_value(logIdle), "Logger thread idle policy [SPIN, YIELD, BACKOFF]")
+                ("log-cpu", po::value<int>(&logCpu)->default_value(logCpu), "CPU affinity index of the logger thread (< 0 for any core)")
                 ("log-folder", po::value<std::string>(&logFolder)->required(), "Path to where the log file will be saved")
                 ("profiled", po::value<bool>(&profiled)->default_value(profiled), "Profiling mode")
                 ("instrument", po::value<std::string>(&instrument)->required(), "Instrument being recorded")
@@ -81,6 +88,9 @@ struct Config
     std::string logFolder;
     LogLevel logLevel = LogLevel::INFO;
     bool printLogs = false;
+    LogOverflow logOverflow = LogOverflow::SPILL;
+    LogIdle logIdle = LogIdle::BACKOFF;
+    int logCpu = -1;
     bool profiled = false;
     std::string instrument; // logger uses this
 };
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "phoenix/enums/log_idle.hpp"
+#include "phoenix/enums/log_level.hpp"
+#include "phoenix/enums/log_overflow.hpp"
+
+#include <boost/describe/enum_from_string.hpp>
+#include <boost/describe/enum_to_string.hpp>
+#include <boost/program_options.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+namespace po = boost::program_options;
+}
+
+namespace phoenix::gateway {
+
+template<typename Traits>
+struct Config
+{
+    bool apply(int argc, char* argv[])
+    {
+        try
+        {
+            po::options_description desc("Config");
+
+            // clang-format off
+            desc.add_options()
+                ("help,h", "see all commands")
+
+                // deribit
+                ("auth-username", po::value<std::string>(&username)->required(), "Deribit username")
+                ("auth-secret", po::value<std::string>(&secret)->required(), "Deribit client secret")
+                ("host", po::value<std::string>(&host)->default_value(host), "Deribit host address ([www/test].deribit.com for [prod/test])")
+                ("port", po::value<std::string>(&port)->default_value(port), "Deribit port (usually 9881 for TCP)")
+                ("client", po::value<std::string>(&client)->default_value(client), "Unique client name")
+                ("colo", po::value<bool>(&colo)->default_value(colo), "Colo mode")
+
+                // strategies
+                ("channel", po::value<std::vector<std::string>>(&channels)->required()->multitoken(), "POSIX shared memory names of the strategy channels, one per strategy process set to it in gateway, e.g. /phoenix-gw-usd")
+                ("cpu", po::value<int>(&cpu)->default_value(cpu), "CPU exclusive affinity index (< 0 for shared core)")
+
+                // logging
+                ("log-level", po::value<LogLevel>(&logLevel)->default_value(logLevel), "Log level [DEBUG, INFO, WARN, ERROR, FATAL]")
+                ("log-print", po::value<bool>(&printLogs)->default_value(printLogs), "Print all logs")
+                ("log-overflow", po::value<LogOverflow>(&logOverflow)->default_value(logOverflow), "Logger overflow policy [DROP, DROP_VERBOSE, SPILL]")
+                ("log-idle", po::value<LogIdle>(&logIdle)->default_value(logIdle), "Logger thread idle policy [SPIN, YIELD, BACKOFF]")
+                ("log-cpu", po::value<int>(&logCpu)->default_value(logCpu), "CPU affinity index of the logger thread (< 0 for any core)")
+                ("log-folder", po::value<std::string>(&logFolder)->required(), "Path to where the log file will be saved")
+                ("log-prefix", po::value<std::string>(&instrument)->default_value(instrument), "Prefix for all log files")
+                ("profiled", po::value<bool>(&profiled)->default_value(profiled), "Profiling mode")
+            ;
+            // clang-format on
+
+            po::variables_map vm;
+            po::store(po::parse_command_line(argc, argv, desc), vm);
+
+            if (vm.count("help"))
+            {
+                std::cout << desc << std::endl;
+                return false;
+            }
+
+            po::notify(vm);
+            return true;
+        }
+        catch (po::error const& e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return false;
+        }
+        catch (std::exception const& e)
+        {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    // deribit connectivity
+    std::string username;
+    std::string secret;
+    std::string client;
+    std::string host = "www.deribit.com"; // test.deribit.com:9881 for test net
+    std::string port = "9881";
+    bool colo = false;
+
+    // strategies
+    std::vector<std::string> channels;
+    int cpu = -1;
+
+    // logging
+    std::string logFolder;
+    LogLevel logLevel = LogLevel::INFO;
+    bool printLogs = false;
+    LogOverflow logOverflow = LogOverflow::SPILL;
+    LogIdle logIdle = LogIdle::BACKOFF;
+    int logCpu = -1;
+    bool profiled = false;
+    std::string instrument = "GATEWAY"; // logger uses this
+};
+
+} // namespace phoenix::gateway
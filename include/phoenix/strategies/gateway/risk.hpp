@@ -0,0 +1,24 @@
+#pragma once
+
+#include "phoenix/tags.hpp"
+
+#include <cstdlib>
+
+namespace phoenix::gateway {
+
+template<typename NodeBase>
+struct Risk : NodeBase
+{
+    using NodeBase::NodeBase;
+
+    // cancel on disconnect is enabled on login, so every strategy's orders go with the session
+    void handle(tag::Risk::Abort)
+    {
+        this->getHandler()->invoke(tag::FlightRecorder::Dump{}, "Risk::Abort");
+        this->getHandler()->invoke(tag::Stream::Stop{});
+        this->getHandler()->invoke(tag::Logger::Stop{});
+        std::abort();
+    }
+};
+
+} // namespace phoenix::gateway
@@ -0,0 +1,368 @@
+#pragma once
+
+#include "phoenix/common/logger.hpp"
+#include "phoenix/data/fix.hpp"
+#include "phoenix/data/gateway.hpp"
+#include "phoenix/data/order_table.hpp"
+#include "phoenix/data/orders.hpp"
+#include "phoenix/tags.hpp"
+#include "phoenix/tools/fixed_string.hpp"
+#include "phoenix/tools/shm_region.hpp"
+#include "phoenix/tools/tracepoints.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <string>
+#include <string_view>
+
+namespace phoenix::gateway {
+
+// The one FIX session of the account for every strategy process, each on its own GatewayChannel in shared memory
+// The rate limit of the account is spent here in one place: every channel has a ring per priority, the highest priority
+// any channel has waiting goes out as soon as the TCPSocket has the credits for it, the channel after the last one served wins a tie
+// ClOrdIDs are stamped with the route of their channel, and reports go back to the channel their 41 (11 of a 35=9) names
+template<typename NodeBase>
+struct Stream : NodeBase
+{
+    // routes fit the bits above CL_ORD_ID_ROUTE_SHIFT
+    static constexpr std::size_t MAX_CHANNELS = 16u;
+
+    Stream(auto const& config, auto& handler)
+        : NodeBase{config, handler}
+        , fixBuilder(config.client)
+    {}
+
+    void handle(tag::Stream::Stop)
+    {
+        auto logoutMsg = fixBuilder.logout(nextSeqNum);
+        isRunning = false;
+        this->getHandler()->invoke(tag::TCPSocket::Stop{}, logoutMsg);
+
+        // strategies still attached see the channel retired
+        for (std::size_t i = 0u; i < numChannels; ++i)
+        {
+            channels[i].shared->header.magic.store(0u, std::memory_order_release);
+            channels[i].region.close();
+        }
+    }
+
+    void handle(tag::Stream::Start)
+    {
+        auto* handler = this->getHandler();
+        auto* config = this->getConfig();
+
+        openChannels();
+        handler->invoke(tag::TCPSocket::Connect{}, config->host, config->port, config->colo);
+        login();
+        isRunning = true;
+
+        startPipeline();
+    }
+
+private:
+    struct Channel
+    {
+        ShmRegion region;
+        GatewayChannel* shared = nullptr;
+        std::string name;
+        std::uint64_t numSent = 0u;
+        std::uint64_t numReports = 0u;
+    };
+
+    // what the FIXMessageBuilder reads of an order, with price and volume as the text the strategy formatted
+    struct Outgoing
+    {
+        struct Text
+        {
+            std::string_view value;
+            std::string_view str() const { return value; }
+        };
+
+        std::string_view symbol;
+        Text price;
+        Text volume;
+        unsigned side;
+        bool takeProfit;
+        bool isFOK;
+        ClOrdId clOrdId;
+        FixedString<ORDER_ID_CAPACITY> orderId;
+    };
+
+    void openChannels()
+    {
+        auto* handler = this->getHandler();
+        auto const& names = this->getConfig()->channels;
+        PHOENIX_LOG_VERIFY(handler, (names.size() <= MAX_CHANNELS), "Too many channels", names.size());
+
+        auto const sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+        auto const epoch = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count());
+
+        for (auto const& name : names)
+        {
+            auto& channel = channels[numChannels];
+            int const error = channel.region.create(name, sizeof(GatewayChannel));
+            PHOENIX_LOG_VERIFY(handler, (!error), "Failed to create gateway channel", name, std::strerror(error));
+
+            channel.shared = new (channel.region.get()) GatewayChannel{};
+            channel.shared->header.version = GatewayChannel::VERSION;
+            channel.shared->header.route = static_cast<std::uint32_t>(numChannels + 1u);
+            channel.shared->header.epoch = epoch;
+
+            // strategies read the rest of the header only after the magic
+            channel.shared->header.magic.store(GatewayChannel::MAGIC, std::memory_order_release);
+
+            channel.name = name;
+            ++numChannels;
+            PHOENIX_LOG_INFO(handler, "Opened gateway channel", name, "route", numChannels);
+        }
+    }
+
+    void startPipeline()
+    {
+        auto* handler = this->getHandler();
+        PHOENIX_LOG_INFO(handler, "Starting gateway pipeline");
+
+        while (isRunning)
+        {
+            try
+            {
+                if (std::chrono::steady_clock::now() - heartbeatLastSent > HEARTBEAT_INTERVAL) [[unlikely]]
+                {
+                    isHeartbeatDue = true;
+                    heartbeatLastSent = std::chrono::steady_clock::now();
+                    logChannels();
+                }
+
+                release();
+
+                // heartbeats, and replies to a TestRequest, only take credits the strategies left
+                if (isHeartbeatDue && handler->retrieve(tag::TCPSocket::Send{}, heartbeat()))
+                {
+                    ++nextSeqNum;
+                    isHeartbeatDue = false;
+                    dueTestReqId.clear();
+                }
+
+                // never blocks, the channels are polled on every loop
+                if (!handler->retrieve(tag::TCPSocket::Available{}))
+                    continue;
+
+                auto msgOpt = handler->retrieve(tag::TCPSocket::Receive{});
+                if (!msgOpt)
+                    continue;
+
+                route(*msgOpt);
+            }
+            catch (std::exception const& e)
+            {
+                PHOENIX_LOG_FATAL(handler, "Error in gateway pipeline", e.what());
+                break;
+            }
+        }
+    }
+
+    // Sends the best front of the channels until none is left or the credits run out
+    // A lower priority never takes the credits a higher one is waiting for
+    [[gnu::hot, gnu::always_inline]]
+    inline void release()
+    {
+        auto* handler = this->getHandler();
+        while (true)
+        {
+            std::size_t best = numChannels;
+            std::size_t bestPriority = 0u;
+            for (std::size_t priority = 0u; priority < NUM_PRIORITIES && best == numChannels; ++priority)
+            {
+                for (std::size_t n = 0u; n < numChannels; ++n)
+                {
+                    std::size_t const i = (nextChannel + n) % numChannels;
+                    if (channels[i].shared->orders[priority].getAvailable())
+                    {
+                        best = i;
+                        bestPriority = priority;
+                        break;
+                    }
+                }
+            }
+
+            if (best == numChannels)
+                return;
+
+            auto& channel = channels[best];
+            auto& orders = channel.shared->orders[bestPriority];
+
+            // a batch is published whole, so it's all there
+            std::size_t const size = std::clamp<std::size_t>(orders.peek().batchSize, 1u, orders.getAvailable());
+            if (!handler->retrieve(tag::TCPSocket::CheckThrottle{}, size))
+                return;
+
+            batch.clear();
+            for (std::size_t i = 0u; i < size; ++i)
+                batch.add(encode(orders.peek(i), channel.shared->header.route));
+
+            handler->invoke(tag::TCPSocket::SendUnthrottled{}, batch.view());
+            orders.pop(size);
+            channel.numSent += size;
+            nextChannel = best + 1u;
+        }
+    }
+
+    // under the next sequence number, with the route of the channel in the ClOrdID
+    [[gnu::hot, gnu::always_inline]]
+    inline std::string_view encode(GatewayOrder const& record, std::uint32_t channelRoute)
+    {
+        // clang-format off
+        Outgoing order{
+            .symbol = record.symbol.view(),
+            .price = {record.price.view()},
+            .volume = {record.volume.view()},
+            .side = record.side,
+            .takeProfit = record.takeProfit,
+            .isFOK = record.isFOK,
+            .clOrdId = withRoute(record.clOrdId ? record.clOrdId : nextSeqNum, channelRoute),
+            .orderId = record.orderId
+        };
+        // clang-format on
+
+        std::string_view msg;
+        switch (record.action)
+        {
+        case OrderAction::NEW: msg = fixBuilder.newOrderSingle(nextSeqNum, order.symbol, order); break;
+        case OrderAction::REPLACE: msg = fixBuilder.orderCancelReplaceRequest(nextSeqNum, order.symbol, order); break;
+        case OrderAction::CANCEL: msg = fixBuilder.orderCancelRequest(nextSeqNum, order.symbol, order.orderId, order.clOrdId); break;
+        }
+
+        ++nextSeqNum;
+        return msg;
+    }
+
+    // execution reports and cancel rejects go back to the channel of their order, the session keeps the rest
+    [[gnu::hot, gnu::always_inline]]
+    inline void route(std::string_view msg)
+    {
+        auto* handler = this->getHandler();
+        reader.init(msg);
+        auto const msgType = reader.getMessageType();
+        PHOENIX_TRACE(parse, msg.size());
+
+        if (msgType == "8" || msgType == "9") [[likely]]
+        {
+            PHOENIX_TRACE(exec_report, msg.data(), msg.size());
+
+            // a cancel reject names the replace or cancel in 11, a report the order in 41
+            ClOrdId const id = parseClOrdId(reader.getStringView(msgType == "9" ? 11u : 41u));
+            std::uint32_t const channelRoute = getRoute(id);
+            if (!channelRoute || channelRoute > numChannels) [[unlikely]]
+            {
+                PHOENIX_LOG_WARN(handler, "Report without a channel", reader.getStringView(11), reader.getStringView(41));
+                return;
+            }
+
+            forward(channels[channelRoute - 1u], msg);
+            return;
+        }
+
+        // heartbeat
+        if (msgType == "0")
+            return;
+
+        // test request
+        if (msgType == "1")
+        {
+            isHeartbeatDue = true;
+            dueTestReqId = reader.getStringView(112);
+            PHOENIX_LOG_INFO(handler, "Received TestRequest, Heartbeat due");
+            return;
+        }
+
+        PHOENIX_LOG_WARN(handler, "Unrouted message", msgType, reader.getStringView(58));
+    }
+
+    std::string_view heartbeat()
+    {
+        return dueTestReqId.empty() ? fixBuilder.heartbeat(nextSeqNum) : fixBuilder.heartbeat(nextSeqNum, dueTestReqId.view());
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void forward(Channel& channel, std::string_view msg)
+    {
+        auto* handler = this->getHandler();
+        if (msg.size() > GatewayReport::MAX_SIZE) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "Report too long for the channel", channel.name, msg.size());
+            return;
+        }
+
+        auto* report = channel.shared->reports.reserve();
+        if (!report) [[unlikely]]
+        {
+            channel.shared->header.dropped.fetch_add(1u, std::memory_order_relaxed);
+            PHOENIX_LOG_WARN(handler, "Report dropped, strategy behind on channel", channel.name);
+            return;
+        }
+
+        report->size = static_cast<std::uint32_t>(msg.size());
+        std::memcpy(report->data, msg.data(), msg.size());
+        channel.shared->reports.commit();
+        ++channel.numReports;
+    }
+
+    void logChannels()
+    {
+        auto* handler = this->getHandler();
+        for (std::size_t i = 0u; i < numChannels; ++i)
+        {
+            auto const& channel = channels[i];
+            PHOENIX_LOG_INFO(
+                handler,
+                "[GATEWAY]",
+                channel.name,
+                "sent",
+                channel.numSent,
+                "reports",
+                channel.numReports,
+                "dropped",
+                channel.shared->header.dropped.load(std::memory_order_relaxed));
+        }
+    }
+
+    void login()
+    {
+        auto* handler = this->getHandler();
+        auto* config = this->getConfig();
+
+        auto msg = fixBuilder.login(nextSeqNum, config->username, config->secret, 120);
+        handler->invoke(tag::TCPSocket::ForceSend{}, msg);
+        ++nextSeqNum;
+
+        auto recvMsg = handler->retrieve(tag::TCPSocket::ForceReceive{});
+        FIXReader loginReader{recvMsg};
+        PHOENIX_LOG_VERIFY(
+            handler, loginReader.isMessageType("A"), "Login unsuccessful with message type", loginReader.getMessageType());
+        PHOENIX_LOG_INFO(handler, "Login successful");
+    }
+
+    bool isRunning = false;
+    bool isHeartbeatDue = false;
+    FixedString<TEST_REQ_ID_CAPACITY> dueTestReqId; // of a TestRequest the due heartbeat answers
+    std::size_t nextSeqNum = 1u;
+    FIXMessageBuilder fixBuilder;
+    FIXBatch batch;
+    FIXReaderFast reader;
+
+    std::array<Channel, MAX_CHANNELS> channels;
+    std::size_t numChannels = 0u;
+    std::size_t nextChannel = 0u;
+
+    static constexpr std::chrono::seconds HEARTBEAT_INTERVAL{80u};
+    std::chrono::steady_clock::time_point heartbeatLastSent = std::chrono::steady_clock::now();
+};
+
+} // namespace phoenix::gateway
@@ -1,4 +1,6 @@
+#include "phoenix/enums/log_idle.hpp"
 #include "phoenix/enums/log_level.hpp"
+#include "phoenix/enums/log_overflow.hpp"
 
 #include <boost/describe/enum_from_string.hpp>
 #include <boost/describe/enum_to_string.hpp>
@@ -36,16 +38,29 @@ struct Config
                 ("client", po::value<std::string>(&client)->default_value(client), "Unique client name")
                 ("log-level", po::value<LogLevel>(&logLevel)->default_value(logLevel), "Log level [DEBUG, INFO, WARN, ERROR, FATAL]")
                 ("log-print", po::value<bool>(&printLogs)->default_value(printLogs), "Print all logs")
+                ("log-overflow", po::value<LogOverflow>(&logOverflow)->default_value(logOverflow), "Logger overflow policy [DROP, DROP_VERBOSE, SPILL]")
+                ("log-idle", po::value<LogIdle>(&logIdle)->default_value(logIdle), "Logger thread idle policy [SPIN, YIELD, BACKOFF]")
+                ("log-cpu", po::value<int>(&logCpu)->default_value(logCpu), "CPU affinity index of the logger thread (< 0 for any core)")
                 ("log-folder", po::value<std::string>(&logFolder)->required(), "Path to where the log file will be saved")
                 ("log-prefix", po::value<std::string>(&instrument)->required(), "Prefix for all log files")
-                ("instrument", po::value<std::vector<std::string>>(&instrumentList)->required(), "List of instruments (should be 3)")
+                ("instrument", po::value<std::vector<std::string>>(&instrumentList)->required(), "List of instruments (3 for the fixed triangles, any set of spot pairs for the cycle engine)")
                 ("profiled", po::value<bool>(&profiled)->default_value(profiled), "Profiling mode")
+                ("perf-counters", po::value<bool>(&perfCounters)->default_value(perfCounters), "Hardware counters per pipeline stage, reported every heartbeat and on stop (needs perf_event access)")
                 ("trigger-threshold", po::value<double>(&triggerThreshold)->default_value(triggerThreshold), "Trigger threshold for risk reduction")
                 ("contract-size", po::value<double>(&contractSize)->default_value(contractSize), "Asset contract size")
+                ("lot-size", po::value<std::vector<double>>(&lotSizeList)->multitoken(), "Lot size of each instrument, in the same order (contract-size for the ones left out)")
+                ("max-volume", po::value<std::vector<double>>(&maxVolumeList)->multitoken(), "Max volume of each instrument per order of a cycle, in its base currency and the same order (volume-size for the ones left out)")
                 ("volume-size", po::value<double>(&volumeSize)->default_value(volumeSize), "Asset contract size")
                 ("colo", po::value<bool>(&colo)->default_value(colo), "Colo mode")
                 ("cpu", po::value<int>(&cpu)->default_value(cpu), "CPU exclusive affinity index (< 0 for shared core)")
                 ("qty-threshold", po::value<double>(&qtyThreshold)->default_value(qtyThreshold), "Min quantity to register top level prices")
+                ("book-depth", po::value<unsigned>(&bookDepth)->default_value(bookDepth), "Levels per side in the market data subscription, used to size the legs")
+                ("md-conflation", po::value<bool>(&mdConflation)->default_value(mdConflation), "Drain every message already received before evaluating, once per changed instrument")
+                ("stale-threshold-us", po::value<unsigned>(&staleThresholdUs)->default_value(staleThresholdUs), "Max exchange to local latency of a book to trigger on it, in microseconds (0 for none)")
+                ("cycle-legs", po::value<unsigned>(&cycleLegs)->default_value(cycleLegs), "Longest cycle the cycle engine watches [3, 4]")
+                ("cycle-min-edge", po::value<double>(&cycleMinEdge)->default_value(cycleMinEdge), "Min return of a cycle to hit it, e.g. 0.0015 to clear three taker fees")
+                ("book-shm", po::value<std::string>(&bookShm)->default_value(bookShm), "POSIX shared memory name to publish the books to, e.g. /phoenix-books (empty for none)")
+                ("gateway", po::value<std::string>(&gateway)->default_value(gateway), "POSIX shared memory name of an order gateway channel to send orders through, e.g. /phoenix-gw-btc (empty for our own session)")
             ;
             // clang-format on
 
@@ -59,7 +74,11 @@ struct Config
             }
 
             po::notify(vm);
-            assert(instrumentList.size() == 3);
+            assert(instrumentList.size() >= 3);
+            assert(lotSizeList.size() <= instrumentList.size());
+            lotSizeList.resize(instrumentList.size(), contractSize);
+            assert(maxVolumeList.size() <= instrumentList.size());
+            maxVolumeList.resize(instrumentList.size(), volumeSize);
             std::size_t i = 0u;
             for (auto const& e : instrumentList)
             {
@@ -92,6 +111,9 @@ struct Config
     std::string logFolder;
     LogLevel logLevel = LogLevel::INFO;
     bool printLogs = false;
+    LogOverflow logOverflow = LogOverflow::SPILL;
+    LogIdle logIdle = LogIdle::BACKOFF;
+    int logCpu = -1;
     std::string instrument; // for logging
 
     // settings
@@ -99,11 +121,21 @@ struct Config
     double contractSize = 0.0001;
     double volumeSize = 1.0;
     double qtyThreshold = 0.0;
+    unsigned bookDepth = 1u;
+    bool mdConflation = false;
+    unsigned staleThresholdUs = 0u;
+    unsigned cycleLegs = 4u;
+    double cycleMinEdge = 0.0;
+    std::string bookShm;
+    std::string gateway;
 
     std::vector<std::string> instrumentList;
+    std::vector<double> lotSizeList; // per instrument
+    std::vector<double> maxVolumeList; // per instrument
     boost::unordered_flat_map<std::string_view, std::size_t> instrumentMap;
 
     bool profiled = false;
+    bool perfCounters = false;
     bool colo = false;
     int cpu = -1;
 };
@@ -0,0 +1,470 @@
+#pragma once
+
+#include "phoenix/common/book_manager.hpp"
+#include "phoenix/common/logger.hpp"
+#include "phoenix/common/scheduler.hpp"
+#include "phoenix/data/cycles.hpp"
+#include "phoenix/data/fix.hpp"
+#include "phoenix/data/orders.hpp"
+#include "phoenix/graph/router_handler.hpp"
+#include "phoenix/tags.hpp"
+#include "phoenix/tools/tracepoints.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace phoenix::triangular {
+
+// Watches every 3 and 4 leg cycle through the configured spot pairs instead of one hand written triangle
+// An update only re-evaluates the cycles of its instrument, and the best one above the min edge is hit at the touch
+template<typename NodeBase>
+struct CycleHitter : NodeBase
+{
+    using Router = NodeBase::Router;
+    using Config = NodeBase::Config;
+    using Traits = NodeBase::Traits;
+    using Price = NodeBase::Traits::PriceType;
+    using Volume = NodeBase::Traits::VolumeType;
+    using Order = SingleOrder<Traits>;
+    using Top = TopOfBook<Price, Volume>;
+
+    CycleHitter(Config const& config, RouterHandler<Router>& handler)
+        : NodeBase(config, handler)
+        , handler{&handler}
+        , config{&config}
+    {}
+
+    // Builds the cycles and subscribes to every instrument, their tops are owned by the BookManager
+    inline void handle(tag::Hitter::Subscribe)
+    {
+        auto const& instrumentList = config->instrumentList;
+        for (auto const& symbol : instrumentList)
+            PHOENIX_LOG_VERIFY(handler, (CycleSet::splitSymbol(symbol).has_value()), "Not a spot pair", symbol);
+
+        cycles.build(instrumentList, config->cycleLegs);
+        PHOENIX_LOG_VERIFY(handler, (cycles.getNumCycles() > 0u), "No cycles through the instruments");
+        PHOENIX_LOG_INFO(handler, "Watching", cycles.getNumCycles(), "cycles through", cycles.getNumCurrencies(), "currencies");
+        for (std::size_t i = 0u; i < cycles.getNumCycles(); ++i)
+            PHOENIX_LOG_DEBUG(handler, "Cycle", i, describe(i));
+
+        minEdge = std::log1p(config->cycleMinEdge);
+        sentOrders.resize(instrumentList.size());
+        isSettled.resize(instrumentList.size());
+        isFlattening.resize(instrumentList.size());
+        tops.resize(instrumentList.size());
+        locals.fill(NONE);
+
+        for (std::uint32_t i = 0u; i < instrumentList.size(); ++i)
+        {
+            InstrumentId const id = handler->retrieve(tag::BookManager::Intern{}, instrumentList[i]);
+            locals[id] = i;
+            tops[i] = &handler->retrieve(tag::BookManager::GetTop{}, id)->get();
+            handler->invoke(tag::BookManager::Subscribe{}, id, this);
+        }
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void handle(tag::BookManager::Changed, InstrumentId id)
+    {
+        std::uint32_t const instrument = locals[id];
+        auto const& top = *tops[instrument];
+        double const qtyThreshold = config->qtyThreshold;
+
+        // rates are kept current while orders are out, so the next evaluation doesn't see a stale leg
+        // a book that arrived late is left out of every cycle until a timely update
+        bool const isStale = handler->retrieve(tag::ExchangeLatency::IsStale{}, std::size_t{id});
+        double const bid = !isStale && top.bidQty.asDouble() > qtyThreshold ? top.bid.asDouble() : 0.0;
+        double const ask = !isStale && top.askQty.asDouble() > qtyThreshold ? top.ask.asDouble() : 0.0;
+        cycles.setRates(instrument, bid, ask);
+
+        ///////// TRIGGER
+        if (fillMode || isStale)
+            return;
+
+        [[maybe_unused]] auto counters = handler->retrieve(tag::PerfCounters::Guard{}, "trigger");
+
+        auto const edges = cycles.evaluate(instrument);
+        std::size_t best = edges.size();
+        double bestEdge = minEdge;
+        for (std::size_t i = 0u; i < edges.size(); ++i)
+        {
+            if (edges[i] > bestEdge)
+            {
+                bestEdge = edges[i];
+                best = i;
+            }
+        }
+
+        if (best == edges.size()) [[likely]]
+            return;
+
+        hit(cycles.getCyclesOf(instrument)[best], bestEdge);
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void handle(tag::Hitter::ExecutionReport, FIXReaderFast& report)
+    {
+        auto symbol = report.getStringView(55);
+        auto status = report.getNumber<unsigned>(39);
+        auto orderId = report.getStringView(11);
+        auto remaining = report.getDecimal<Volume>(151);
+        auto justExecuted = report.getDecimal<Volume>(14);
+        auto side = report.getNumber<unsigned>(54);
+        auto price = report.getDecimal<Price>(44);
+
+        // our ClOrdID comes back in 41
+        auto const* instrument = openOrders.find(report.getStringView(41));
+        if (!instrument) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "Report for an order that isn't open", orderId, symbol);
+            return;
+        }
+
+        auto& sentOrder = sentOrders[*instrument];
+        switch (status)
+        {
+        case 0:
+        {
+            logOrder("[NEW ORDER]", orderId, side, price, remaining);
+            if (!acceptOrderId(handler, sentOrder, orderId)) [[unlikely]]
+                break;
+
+            sentOrder.isInFlight = false;
+            if (isUnwinding && !isFlattening[*instrument]) [[unlikely]]
+                cancel(*instrument);
+        }
+        break;
+
+        case 1: logOrder("[PARTIAL FILL]", orderId, side, price, justExecuted); break;
+
+        case 2:
+        {
+            unsigned const numFills = report.getNumber<unsigned>(1362);
+            double avgFillPrice = 0.0;
+            double totalQty = 0.0;
+            for (unsigned i = 0u; i < numFills; ++i)
+            {
+                double const fillQty = report.getNumber<double>(1365, i);
+                double const fillPrice = report.getNumber<double>(1364, i);
+                totalQty += fillQty;
+                avgFillPrice += (fillQty * fillPrice);
+            }
+            if (totalQty && avgFillPrice)
+                avgFillPrice /= totalQty;
+
+            logOrder("[FILL]", orderId, side, avgFillPrice, justExecuted);
+
+            sentOrder.isFilled = true;
+            sentOrder.price = avgFillPrice;
+            sentOrder.isInFlight = false;
+
+            if (isUnwinding) [[unlikely]]
+            {
+                if (isFlattening[*instrument])
+                    settle(*instrument);
+                else
+                    flatten(*instrument, sentOrder.volume);
+
+                break;
+            }
+
+            if (++filled == cycles.getCycle(activeCycle).numLegs)
+            {
+                fillMode = false;
+                filled = 0u;
+                PHOENIX_LOG_INFO(handler, "All orders filled");
+                updatePnl();
+
+                auto const& cycle = cycles.getCycle(activeCycle);
+                for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+                    openOrders.erase(sentOrders[cycle.legs[leg].instrument].clOrdId);
+            }
+        }
+        break;
+
+        case 4:
+        {
+            logOrder("[CANCELLED]", orderId, side, price, remaining);
+
+            // a leg cancelled while unwinding is done with, whatever of it filled is flattened
+            if (isUnwinding && !isFlattening[*instrument]) [[unlikely]]
+            {
+                if (justExecuted.asDouble() > 0.0)
+                    flatten(*instrument, justExecuted);
+                else
+                    settle(*instrument);
+
+                break;
+            }
+
+            // chases the touch under the same ClOrdID, the other legs are already out
+            auto const& top = *tops[*instrument];
+            sentOrder.price = sentOrder.side == 1 ? top.ask : top.bid;
+
+            // ahead of anything but cancels, without stalling the loop on the throttle
+            bool const isAccepted = handler->retrieve(tag::Scheduler::Submit{}, Priority::HEDGE, OrderAction::NEW, sentOrder).isAccepted;
+            PHOENIX_LOG_VERIFY(handler, (isAccepted), "No room to queue a retry", symbol);
+
+            sentOrder.lastSent = std::chrono::steady_clock::now();
+            sentOrder.isInFlight = true;
+            PHOENIX_LOG_INFO(handler, "Retrying", symbol);
+        }
+        break;
+
+        case 8:
+        {
+            auto reason = report.getStringView(103);
+            logOrder("[REJECTED]", orderId, side, price, remaining, reason);
+
+            if (isFlattening[*instrument])
+            {
+                PHOENIX_LOG_ERROR(handler, "[UNWIND] Flattening rejected, position left open", symbol, sentOrder.volume.asDouble());
+                settle(*instrument);
+            }
+            else
+                unwind(*instrument);
+        }
+        break;
+
+        default: PHOENIX_LOG_WARN(handler, "Other status type", status); break;
+        };
+    }
+
+    inline void handle(tag::Hitter::InitBalances) {}
+
+private:
+    static constexpr std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+
+    // Walks the cycle once to size it, the leg with the least liquidity (or max-volume of its instrument) caps the starting amount
+    inline void hit(std::uint32_t index, double edge)
+    {
+        auto const& cycle = cycles.getCycle(index);
+
+        // base volume of every leg per unit of the start currency
+        std::array<double, Cycle::MAX_LEGS> perUnit{};
+        double amount = 1.0;
+        double start = std::numeric_limits<double>::max();
+        for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+        {
+            auto const& [instrument, isBuy] = cycle.legs[leg];
+            auto const& top = *tops[instrument];
+            double const price = (isBuy ? top.ask : top.bid).asDouble();
+            double const qty = (isBuy ? top.askQty : top.bidQty).asDouble();
+
+            perUnit[leg] = isBuy ? amount / price : amount;
+            start = std::min({start, qty / perUnit[leg], config->maxVolumeList[instrument] / perUnit[leg]});
+            amount = isBuy ? perUnit[leg] : perUnit[leg] * price;
+        }
+
+        std::array<Order, Cycle::MAX_LEGS> orders;
+        for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+        {
+            auto const& [instrument, isBuy] = cycle.legs[leg];
+            auto const& top = *tops[instrument];
+            double const lotSize = config->lotSizeList[instrument];
+            Volume const volume{std::floor(start * perUnit[leg] / lotSize) * lotSize};
+            if (!volume)
+            {
+                PHOENIX_LOG_DEBUG(handler, "Cycle", index, "is below one lot on", config->instrumentList[instrument]);
+                return;
+            }
+
+            // clang-format off
+            orders[leg] = {
+                .symbol = config->instrumentList[instrument],
+                .price = isBuy ? top.ask : top.bid,
+                .volume = volume,
+                .side = isBuy ? 1u : 2u,
+            };
+            // clang-format on
+        }
+
+        for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+            orders[leg].clOrdId = openOrders.insert(cycle.legs[leg].instrument);
+
+        PHOENIX_TRACE(trigger, index);
+        handler->invoke(tag::FlightRecorder::Decision{}, "cycle", index, edge, start);
+
+        bool const sent = cycle.numLegs == 3u
+            ? handler->retrieve(tag::Stream::TakeMarketOrders{}, orders[0], orders[1], orders[2])
+            : handler->retrieve(tag::Stream::TakeMarketOrders{}, orders[0], orders[1], orders[2], orders[3]);
+
+        if (sent)
+        {
+            for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+                sentOrders[cycle.legs[leg].instrument] = orders[leg];
+
+            activeCycle = index;
+            startAmount = start;
+            fillMode = true;
+            filled = 0u;
+            PHOENIX_LOG_INFO(handler, "[OPP] Cycle", index, "from", cycles.getStartCurrency(index), "edge", std::expm1(edge), "size", start);
+        }
+        else
+        {
+            for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+                openOrders.erase(orders[leg].clOrdId);
+
+            PHOENIX_LOG_INFO(handler, "[OPP THROTTLED] Cycle", index, "edge", std::expm1(edge), "not sent");
+        }
+    }
+
+    // Same as the triangle's: filled legs of the active cycle are flattened, working ones cancelled,
+    // and the next cycle can be hit once every leg is settled
+    inline void unwind(std::uint32_t rejected)
+    {
+        if (!isUnwinding)
+            PHOENIX_LOG_WARN(handler, "[UNWIND] Cycle", activeCycle, "rejected on", config->instrumentList[rejected]);
+
+        isUnwinding = true;
+        settle(rejected);
+
+        auto const& cycle = cycles.getCycle(activeCycle);
+        for (std::uint32_t leg = 0u; leg < cycle.numLegs && isUnwinding; ++leg)
+        {
+            std::uint32_t const instrument = cycle.legs[leg].instrument;
+            auto const& order = sentOrders[instrument];
+            if (isSettled[instrument] || isFlattening[instrument])
+                continue;
+
+            if (order.isFilled)
+                flatten(instrument, order.volume);
+            else if (!order.isInFlight)
+                cancel(instrument);
+        }
+    }
+
+    inline void cancel(std::uint32_t instrument)
+    {
+        bool const isAccepted =
+            handler->retrieve(tag::Scheduler::Submit{}, Priority::CANCEL, OrderAction::CANCEL, sentOrders[instrument]).isAccepted;
+        PHOENIX_LOG_VERIFY(handler, (isAccepted), "No room to queue a cancel", sentOrders[instrument].symbol);
+    }
+
+    inline void flatten(std::uint32_t instrument, Volume volume)
+    {
+        auto& order = sentOrders[instrument];
+        openOrders.erase(order.clOrdId);
+
+        auto const& top = *tops[instrument];
+        order.side = order.side == 1 ? 2u : 1u;
+        order.price = order.side == 1 ? top.ask : top.bid;
+        order.volume = volume;
+        order.isFOK = true;
+        order.isFilled = false;
+        order.isInFlight = true;
+        order.orderId.clear();
+        order.clOrdId = openOrders.insert(instrument);
+        order.lastSent = std::chrono::steady_clock::now();
+        isFlattening[instrument] = true;
+
+        bool const isAccepted = handler->retrieve(tag::Scheduler::Submit{}, Priority::HEDGE, OrderAction::NEW, order).isAccepted;
+        PHOENIX_LOG_VERIFY(handler, (isAccepted), "No room to queue a flattening order", order.symbol);
+        PHOENIX_LOG_WARN(handler, "[UNWIND] Flattening", order.symbol, volume.asDouble());
+    }
+
+    inline void settle(std::uint32_t instrument)
+    {
+        isSettled[instrument] = true;
+        openOrders.erase(sentOrders[instrument].clOrdId);
+
+        auto const& cycle = cycles.getCycle(activeCycle);
+        for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+        {
+            if (!isSettled[cycle.legs[leg].instrument])
+                return;
+        }
+
+        for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+        {
+            isSettled[cycle.legs[leg].instrument] = false;
+            isFlattening[cycle.legs[leg].instrument] = false;
+        }
+
+        isUnwinding = false;
+        fillMode = false;
+        filled = 0u;
+        PHOENIX_LOG_INFO(handler, "[UNWIND] Cycle", activeCycle, "unwound");
+    }
+
+    // realised return from the fill prices, in the start currency of the cycle
+    inline void updatePnl()
+    {
+        auto const& cycle = cycles.getCycle(activeCycle);
+        double amount = 1.0;
+        for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+        {
+            auto const& [instrument, isBuy] = cycle.legs[leg];
+            double const price = sentOrders[instrument].price.asDouble();
+            amount = isBuy ? amount / price : amount * price;
+        }
+
+        PHOENIX_LOG_INFO(handler, "[PNL]", (amount - 1.0) * startAmount, "in", cycles.getStartCurrency(activeCycle), "(estimate)");
+    }
+
+    // e.g. USDC > BTC_USDC > ETH_BTC > ETH_USDC
+    inline std::string describe(std::size_t index) const
+    {
+        auto const& cycle = cycles.getCycle(index);
+        std::string out{cycles.getStartCurrency(index)};
+        for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+        {
+            out.append(cycle.legs[leg].isBuy ? " > buy " : " > sell ");
+            out.append(config->instrumentList[cycle.legs[leg].instrument]);
+        }
+
+        return out;
+    }
+
+    inline void logOrder(
+        std::string_view type,
+        std::string_view orderId,
+        unsigned side,
+        Price price,
+        Volume volume,
+        std::string_view rejectReason = "")
+    {
+        PHOENIX_LOG_INFO(
+            handler,
+            type,
+            orderId,
+            side == 1 ? "BUY" : "SELL",
+            volume.asDouble(),
+            '@',
+            price.asDouble(),
+            rejectReason.empty() ? "" : "with reason",
+            rejectReason);
+    }
+
+    RouterHandler<Router>* const handler;
+    Config const* const config;
+
+    CycleSet cycles;
+    double minEdge = 0.0;
+
+    // index in the instrument list by BookManager ID
+    std::array<std::uint32_t, MAX_INSTRUMENTS> locals{};
+    std::vector<Top const*> tops;
+    std::vector<Order> sentOrders;
+
+    // instrument of every order of the cycle in flight
+    OrderTable<std::uint32_t, std::bit_ceil(Cycle::MAX_LEGS)> openOrders;
+
+    bool fillMode = false;
+    unsigned filled = 0u;
+    std::uint32_t activeCycle = 0u;
+    double startAmount = 0.0;
+
+    // after a reject, until every leg of the active cycle is settled, by instrument like sentOrders
+    bool isUnwinding = false;
+    std::vector<bool> isSettled;
+    std::vector<bool> isFlattening;
+};
+
+} // namespace phoenix::triangular
@@ -0,0 +1,628 @@
+#pragma once
+
+#include "phoenix/common/book_manager.hpp"
+#include "phoenix/common/logger.hpp"
+#include "phoenix/common/scheduler.hpp"
+#include "phoenix/data/fix.hpp"
+#include "phoenix/data/orders.hpp"
+#include "phoenix/graph/router_handler.hpp"
+#include "phoenix/strategies/triangular/triangle.hpp"
+#include "phoenix/tags.hpp"
+#include "phoenix/tools/tracepoints.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace phoenix::triangular {
+
+// Hits the triangle described by Traits::TRIANGLE, one leg per instrument of the instrument list
+// Every leg is a compile time constant, so the trigger, sizing and orders unroll with no loops or branches on the leg
+template<typename NodeBase>
+struct Hitter : NodeBase
+{
+    using Router = NodeBase::Router;
+    using Config = NodeBase::Config;
+    using Traits = NodeBase::Traits;
+    using Price = NodeBase::Traits::PriceType;
+    using Volume = NodeBase::Traits::VolumeType;
+    using Order = SingleOrder<Traits>;
+    using Book = OrderBook<Price, Volume>;
+    using Top = TopOfBook<Price, Volume>;
+
+    static constexpr auto const& TRIANGLE = Traits::TRIANGLE;
+    static constexpr std::size_t N = TRIANGLE.legs.size();
+    static_assert(TRIANGLE.isValid(), "Legs need exponents of 1 or -1 and volumes taken from an earlier leg");
+
+    // legs that trigger go out first, their touch is the one the edge was seen on, the rest in instrument order
+    static constexpr std::array<std::size_t, N> SEND_ORDER = []
+    {
+        std::array<std::size_t, N> order{};
+        std::size_t n = 0u;
+        for (bool const triggers : {true, false})
+        {
+            for (std::size_t i = 0u; i < N; ++i)
+                if (TRIANGLE.legs[i].triggers == triggers)
+                    order[n++] = i;
+        }
+
+        return order;
+    }();
+
+    Hitter(Config const& config, RouterHandler<Router>& handler)
+        : NodeBase(config, handler)
+        , handler{&handler}
+        , config{&config}
+    {}
+
+    // Subscribes to the legs, the books and their tops are owned by the BookManager
+    inline void handle(tag::Hitter::Subscribe)
+    {
+        auto const& instrumentList = config->instrumentList;
+        PHOENIX_LOG_VERIFY(handler, (instrumentList.size() == N), "Expected", N, "instruments, got", instrumentList.size());
+
+        for (std::size_t i = 0u; i < N; ++i)
+        {
+            InstrumentId const id = handler->retrieve(tag::BookManager::Intern{}, instrumentList[i]);
+            ids[i] = id;
+            books[i] = handler->retrieve(tag::BookManager::GetBook{}, id);
+            tops[i] = &handler->retrieve(tag::BookManager::GetTop{}, id)->get();
+            handler->invoke(tag::BookManager::Subscribe{}, id, this);
+        }
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void handle(tag::BookManager::Changed, InstrumentId id)
+    {
+        if constexpr (!allLegsTrigger())
+        {
+            bool const isTrigger = [&]<std::size_t... I>(std::index_sequence<I...>)
+            { return ((TRIANGLE.legs[I].triggers && id == ids[I]) || ...); }(std::make_index_sequence<N>{});
+
+            if (!isTrigger)
+                return;
+        }
+
+        ///////// TRIGGER
+        if (fillMode)
+            return;
+
+        // a leg that arrived late may already have moved at the exchange
+        bool const isStale = [&]<std::size_t... I>(std::index_sequence<I...>)
+        { return (handler->retrieve(tag::ExchangeLatency::IsStale{}, std::size_t{ids[I]}) || ...); }(std::make_index_sequence<N>{});
+
+        if (isStale)
+            return;
+
+        [[maybe_unused]] auto counters = handler->retrieve(tag::PerfCounters::Guard{}, "trigger");
+
+        evaluate<true>();
+        if (!fillMode)
+            evaluate<false>();
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void handle(tag::Hitter::ExecutionReport, FIXReaderFast& report)
+    {
+        auto symbol = report.getStringView(55);
+        auto status = report.getNumber<unsigned>(39);
+        auto orderId = report.getStringView(11);
+        auto remaining = report.getDecimal<Volume>(151);
+        auto justExecuted = report.getDecimal<Volume>(14);
+        auto side = report.getNumber<unsigned>(54);
+        auto price = report.getDecimal<Price>(44);
+        PHOENIX_LOG_VERIFY(handler, (!price.error && !remaining.error), "Decimal parse error");
+
+        // our ClOrdID comes back in 41
+        auto const* leg = openOrders.find(report.getStringView(41));
+        if (!leg) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "Report for an order that isn't open", orderId, symbol);
+            return;
+        }
+
+        auto& sentOrder = sentOrders[*leg];
+        switch (status)
+        {
+        case 0:
+        {
+            logOrder("[NEW ORDER]", orderId, side, price, remaining);
+            if (!acceptOrderId(handler, sentOrder, orderId)) [[unlikely]]
+                break;
+
+            sentOrder.isInFlight = false;
+            if (isUnwinding && !isFlattening[*leg]) [[unlikely]]
+                cancel(*leg);
+        }
+        break;
+
+        case 1: logOrder("[PARTIAL FILL]", orderId, side, price, justExecuted); break;
+
+        case 2:
+        {
+            unsigned const numFills = report.getNumber<unsigned>(1362);
+            double avgFillPrice = 0.0;
+            double totalQty = 0.0;
+            for (unsigned i = 0u; i < numFills; ++i)
+            {
+                double const fillQty = report.getNumber<double>(1365, i);
+                double const fillPrice = report.getNumber<double>(1364, i);
+                totalQty += fillQty;
+                avgFillPrice += (fillQty * fillPrice);
+            }
+            if (totalQty && avgFillPrice)
+                avgFillPrice /= totalQty;
+
+            logOrder("[FILL]", orderId, side, avgFillPrice, justExecuted);
+
+            sentOrder.isFilled = true;
+            sentOrder.price = avgFillPrice;
+            sentOrder.isInFlight = false;
+
+            if (isUnwinding) [[unlikely]]
+            {
+                if (isFlattening[*leg])
+                    settle(*leg);
+                else
+                    flatten(*leg, sentOrder.volume);
+
+                break;
+            }
+
+            if (++filled == N)
+            {
+                fillMode = false;
+                filled = 0u;
+                PHOENIX_LOG_INFO(handler, "All orders filled");
+                updatePnl();
+
+                for (auto const& order : sentOrders)
+                    openOrders.erase(order.clOrdId);
+            }
+        }
+        break;
+
+        case 4:
+        {
+            logOrder("[CANCELLED]", orderId, side, price, remaining);
+
+            // a leg cancelled while unwinding is done with, whatever of it filled is flattened
+            if (isUnwinding && !isFlattening[*leg]) [[unlikely]]
+            {
+                if (justExecuted.asDouble() > 0.0)
+                    flatten(*leg, justExecuted);
+                else
+                    settle(*leg);
+
+                break;
+            }
+
+            // chases the touch under the same ClOrdID, the other legs are already out
+            if (sentOrder.side == 1)
+                sentOrder.price = tops[*leg]->ask;
+            else
+                sentOrder.price = tops[*leg]->bid;
+
+            // ahead of anything but cancels, without stalling the loop on the throttle
+            bool const isAccepted = handler->retrieve(tag::Scheduler::Submit{}, Priority::HEDGE, OrderAction::NEW, sentOrder).isAccepted;
+            PHOENIX_LOG_VERIFY(handler, (isAccepted), "No room to queue a retry", symbol);
+
+            sentOrder.lastSent = std::chrono::steady_clock::now();
+            sentOrder.isInFlight = true;
+            PHOENIX_LOG_INFO(handler, "Retrying", symbol);
+        }
+        break;
+
+        case 8:
+        {
+            auto reason = report.getStringView(103);
+            logOrder("[REJECTED]", orderId, side, price, remaining, reason);
+
+            // a first leg, a retry or a flattening order, either way the triangle can't complete
+            if (isFlattening[*leg])
+            {
+                PHOENIX_LOG_ERROR(handler, "[UNWIND] Flattening rejected, position left open", symbol, sentOrder.volume.asDouble());
+                settle(*leg);
+            }
+            else
+                unwind(*leg);
+        }
+        break;
+
+        default: PHOENIX_LOG_WARN(handler, "Other status type", status); break;
+        };
+    }
+
+    inline void handle(tag::Hitter::InitBalances) {}
+
+private:
+    struct Plan
+    {
+        std::array<double, N> volumes;
+        std::array<Price, N> prices;
+    };
+
+    static consteval bool allLegsTrigger()
+    {
+        return std::all_of(TRIANGLE.legs.begin(), TRIANGLE.legs.end(), [](Leg const& leg) { return leg.triggers; });
+    }
+
+    // case 1 sells the legs with a positive exponent
+    template<bool SELL_POSITIVE, std::size_t I>
+    static consteval bool isBuy()
+    {
+        return (TRIANGLE.legs[I].exponent > 0) != SELL_POSITIVE;
+    }
+
+    template<typename Func>
+    [[gnu::always_inline]]
+    static inline void forEachLeg(Func&& func)
+    {
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        { (func.template operator()<I>(), ...); }(std::make_index_sequence<N>{});
+    }
+
+    template<bool SELL_POSITIVE, std::size_t I>
+    [[gnu::always_inline]]
+    inline Price touchPrice() const
+    {
+        if constexpr (isBuy<SELL_POSITIVE, I>())
+            return tops[I]->ask;
+        else
+            return tops[I]->bid;
+    }
+
+    template<bool SELL_POSITIVE, std::size_t I>
+    [[gnu::always_inline]]
+    inline double touchQty() const
+    {
+        if constexpr (isBuy<SELL_POSITIVE, I>())
+            return tops[I]->askQty.asDouble();
+        else
+            return tops[I]->bidQty.asDouble();
+    }
+
+    template<std::size_t I>
+    static inline double roundToLot(double volume)
+    {
+        constexpr double LOT = TRIANGLE.legs[I].lotSize;
+        if constexpr (LOT > 0.0)
+            return std::round(volume / LOT) * LOT;
+        else
+            return volume;
+    }
+
+    template<std::size_t I>
+    static inline double floorToLot(double volume)
+    {
+        constexpr double LOT = TRIANGLE.legs[I].lotSize;
+        if constexpr (LOT > 0.0)
+            return std::floor(volume / LOT) * LOT;
+        else
+            return volume;
+    }
+
+    // The products of the touch prices sold into and bought from, the triangle pays when the first is larger
+    template<bool SELL_POSITIVE>
+    [[gnu::hot, gnu::always_inline]]
+    inline void evaluate()
+    {
+        constexpr unsigned CASE = SELL_POSITIVE ? 1u : 2u;
+        constexpr char const* LABEL = SELL_POSITIVE ? "case 1" : "case 2";
+
+        double sold = 1.0;
+        double bought = 1.0;
+        bool isLiquid = true;
+        forEachLeg(
+            [&]<std::size_t I>()
+            {
+                if constexpr (isBuy<SELL_POSITIVE, I>())
+                    bought *= touchPrice<SELL_POSITIVE, I>().asDouble();
+                else
+                    sold *= touchPrice<SELL_POSITIVE, I>().asDouble();
+
+                if constexpr (TRIANGLE.legs[I].minQty > 0.0)
+                    isLiquid &= touchQty<SELL_POSITIVE, I>() > TRIANGLE.legs[I].minQty;
+            });
+
+        if (!(sold > bought) || !isLiquid) [[likely]]
+            return;
+
+        auto const plan = size<SELL_POSITIVE>();
+        if (!plan) [[unlikely]]
+            return;
+
+        std::array<Order, N> orders;
+        forEachLeg(
+            [&]<std::size_t I>()
+            {
+                // clang-format off
+                orders[I] = {
+                    .symbol = config->instrumentList[I],
+                    .price = plan->prices[I],
+                    .volume = plan->volumes[I],
+                    .side = isBuy<SELL_POSITIVE, I>() ? 1u : 2u,
+                    .isFOK = TRIANGLE.sizing == Sizing::BOOK
+                };
+                // clang-format on
+                orders[I].clOrdId = openOrders.insert(I);
+            });
+
+        PHOENIX_TRACE(trigger, CASE);
+        bool const isSent = [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            handler->invoke(tag::FlightRecorder::Decision{}, LABEL, touchPrice<SELL_POSITIVE, I>()...);
+            return handler->retrieve(tag::Stream::TakeMarketOrders{}, orders[SEND_ORDER[I]]...);
+        }(std::make_index_sequence<N>{});
+
+        if (!isSent)
+        {
+            for (auto const& order : orders)
+                openOrders.erase(order.clOrdId);
+
+            PHOENIX_LOG_INFO(handler, "[OPP THROTTLED] case", CASE, "not sent");
+            return;
+        }
+
+        sentOrders = orders;
+        fillMode = true;
+        filled = 0u;
+        PHOENIX_LOG_INFO(handler, "[OPP CASE", CASE, "] sold", sold, "> bought", bought);
+    }
+
+    template<bool SELL_POSITIVE>
+    [[gnu::always_inline]]
+    inline std::optional<Plan> size() const
+    {
+        if constexpr (TRIANGLE.sizing == Sizing::BOOK)
+            return sizeFromBooks<SELL_POSITIVE>();
+        else
+            return sizeFromTops<SELL_POSITIVE>();
+    }
+
+    // Legs converted by notional at the touch, TOP caps the first leg so no leg takes more than its touch
+    template<bool SELL_POSITIVE>
+    inline std::optional<Plan> sizeFromTops() const
+    {
+        Plan plan;
+        std::array<double, N> ratios; // volume per unit of the first leg
+        double volume = config->volumeSize;
+        forEachLeg(
+            [&]<std::size_t I>()
+            {
+                constexpr Leg LEG = TRIANGLE.legs[I];
+                plan.prices[I] = touchPrice<SELL_POSITIVE, I>();
+
+                if constexpr (I == 0u)
+                    ratios[I] = 1.0;
+                else if constexpr (LEG.byNotional)
+                    ratios[I] = ratios[LEG.volumeOf] * plan.prices[LEG.volumeOf].asDouble() / plan.prices[I].asDouble();
+                else
+                    ratios[I] = ratios[LEG.volumeOf];
+
+                if constexpr (TRIANGLE.sizing == Sizing::TOP)
+                    volume = std::min(volume, touchQty<SELL_POSITIVE, I>() / ratios[I]);
+            });
+
+        bool isEmpty = false;
+        forEachLeg(
+            [&]<std::size_t I>()
+            {
+                plan.volumes[I] = roundToLot<I>(volume * ratios[I]);
+                isEmpty |= plan.volumes[I] <= 0.0;
+            });
+
+        if (isEmpty) [[unlikely]]
+        {
+            PHOENIX_LOG_WARN(handler, "Not enough quantity for case", SELL_POSITIVE ? 1u : 2u);
+            return std::nullopt;
+        }
+
+        return plan;
+    }
+
+    // Sweeps every leg, legs converted by notional at the average price of their source over their own touch
+    // If one runs short every leg shrinks to the shortest one once, and the average prices have to still cross
+    template<bool SELL_POSITIVE>
+    inline std::optional<Plan> sizeFromBooks() const
+    {
+        double volume = floorToLot<0u>(config->volumeSize);
+        for (unsigned attempt = 0u; attempt < 2u && volume > 0.0; ++attempt)
+        {
+            std::array<double, N> volumes;
+            std::array<typename Book::Sweep, N> sweeps;
+            bool isEmpty = false;
+            forEachLeg(
+                [&]<std::size_t I>()
+                {
+                    constexpr Leg LEG = TRIANGLE.legs[I];
+                    if constexpr (I == 0u)
+                        volumes[I] = volume;
+                    else if constexpr (LEG.byNotional)
+                        volumes[I] = roundToLot<I>(
+                            volumes[LEG.volumeOf] * sweeps[LEG.volumeOf].getAveragePrice() /
+                            touchPrice<SELL_POSITIVE, I>().asDouble());
+                    else
+                        volumes[I] = volumes[LEG.volumeOf];
+
+                    isEmpty |= volumes[I] <= 0.0;
+                    if constexpr (isBuy<SELL_POSITIVE, I>())
+                        sweeps[I] = books[I]->getBuyCost(Volume{volumes[I]});
+                    else
+                        sweeps[I] = books[I]->getSellCost(Volume{volumes[I]});
+                });
+
+            if (isEmpty)
+                break;
+
+            bool isComplete = true;
+            double scale = 1.0;
+            double sold = 1.0;
+            double bought = 1.0;
+            forEachLeg(
+                [&]<std::size_t I>()
+                {
+                    isComplete &= sweeps[I].isComplete;
+                    scale = std::min(scale, sweeps[I].volume.asDouble() / volumes[I]);
+                    if constexpr (isBuy<SELL_POSITIVE, I>())
+                        bought *= sweeps[I].getAveragePrice();
+                    else
+                        sold *= sweeps[I].getAveragePrice();
+                });
+
+            if (!isComplete)
+            {
+                volume = floorToLot<0u>(volume * scale);
+                continue;
+            }
+
+            if (!(sold > bought))
+            {
+                PHOENIX_LOG_INFO(handler, "[OPP CASE", SELL_POSITIVE ? 1u : 2u, "] Gone at size", volume);
+                return std::nullopt;
+            }
+
+            Plan plan;
+            forEachLeg(
+                [&]<std::size_t I>()
+                {
+                    plan.volumes[I] = volumes[I];
+                    plan.prices[I] = sweeps[I].worstPrice;
+                });
+
+            return plan;
+        }
+
+        PHOENIX_LOG_WARN(handler, "Not enough quantity for case", SELL_POSITIVE ? 1u : 2u);
+        return std::nullopt;
+    }
+
+    // Takes the triangle back to flat once a leg of it can't fill: the legs that filled are flattened,
+    // the ones working are cancelled, or as soon as their ack arrives, and the hitter trades again once every leg is settled
+    inline void unwind(std::size_t rejected)
+    {
+        if (!isUnwinding)
+            PHOENIX_LOG_WARN(handler, "[UNWIND] Leg", rejected, "rejected, unwinding the triangle");
+
+        isUnwinding = true;
+        settle(rejected);
+        for (std::size_t i = 0u; i < N && isUnwinding; ++i)
+        {
+            auto const& order = sentOrders[i];
+            if (isSettled[i] || isFlattening[i])
+                continue;
+
+            if (order.isFilled)
+                flatten(i, order.volume);
+            else if (!order.isInFlight)
+                cancel(i);
+        }
+    }
+
+    inline void cancel(std::size_t leg)
+    {
+        bool const isAccepted =
+            handler->retrieve(tag::Scheduler::Submit{}, Priority::CANCEL, OrderAction::CANCEL, sentOrders[leg]).isAccepted;
+        PHOENIX_LOG_VERIFY(handler, (isAccepted), "No room to queue a cancel", sentOrders[leg].symbol);
+    }
+
+    // the opposite side of what the leg filled, FOK at the touch and chased like a retry until it fills
+    inline void flatten(std::size_t leg, Volume volume)
+    {
+        auto& order = sentOrders[leg];
+        openOrders.erase(order.clOrdId);
+
+        order.side = order.side == 1 ? 2u : 1u;
+        order.price = order.side == 1 ? tops[leg]->ask : tops[leg]->bid;
+        order.volume = volume;
+        order.isFOK = true;
+        order.isFilled = false;
+        order.isInFlight = true;
+        order.orderId.clear();
+        order.clOrdId = openOrders.insert(leg);
+        order.lastSent = std::chrono::steady_clock::now();
+        isFlattening[leg] = true;
+
+        bool const isAccepted = handler->retrieve(tag::Scheduler::Submit{}, Priority::HEDGE, OrderAction::NEW, order).isAccepted;
+        PHOENIX_LOG_VERIFY(handler, (isAccepted), "No room to queue a flattening order", order.symbol);
+        PHOENIX_LOG_WARN(handler, "[UNWIND] Flattening", order.symbol, volume.asDouble());
+    }
+
+    inline void settle(std::size_t leg)
+    {
+        isSettled[leg] = true;
+        openOrders.erase(sentOrders[leg].clOrdId);
+
+        if (!std::all_of(isSettled.begin(), isSettled.end(), [](bool isLegSettled) { return isLegSettled; }))
+            return;
+
+        isUnwinding = false;
+        isSettled.fill(false);
+        isFlattening.fill(false);
+        fillMode = false;
+        filled = 0u;
+        PHOENIX_LOG_INFO(handler, "[UNWIND] Triangle unwound");
+    }
+
+    // the price difference of the two sides of the identity, at the volume of the leg alone on its side
+    inline void updatePnl()
+    {
+        double sold = 1.0;
+        double bought = 1.0;
+        for (auto const& order : sentOrders)
+            (order.side == 1 ? bought : sold) *= order.price.asDouble();
+
+        double const multiplier = sentOrders[TRIANGLE.pnlLeg].volume.asDouble() * config->contractSize;
+        pnl += (sold - bought) * multiplier;
+
+        PHOENIX_LOG_INFO(handler, "[PNL]", pnl, TRIANGLE.pnlCurrency, "(estimate)");
+    }
+
+    inline void logOrder(
+        std::string_view type,
+        std::string_view orderId,
+        unsigned side,
+        Price price,
+        Volume volume,
+        std::string_view rejectReason = "")
+    {
+        PHOENIX_LOG_INFO(
+            handler,
+            type,
+            orderId,
+            side == 1 ? "BUY" : "SELL",
+            volume.asDouble(),
+            '@',
+            price.asDouble(),
+            rejectReason.empty() ? "" : "with reason",
+            rejectReason);
+    }
+
+    RouterHandler<Router>* const handler;
+    Config const* const config;
+
+    std::array<InstrumentId, N> ids{};
+    std::array<Book const*, N> books{};
+    std::array<Top const*, N> tops{};
+    std::array<Order, N> sentOrders;
+
+    // leg of every order of the triangle in flight, a new triangle only goes out once the last one is filled
+    OrderTable<std::uint32_t, std::bit_ceil(N)> openOrders;
+
+    bool fillMode = false;
+    unsigned filled = 0u;
+
+    // after a reject, until every leg is settled
+    bool isUnwinding = false;
+    std::array<bool, N> isSettled{};
+    std::array<bool, N> isFlattening{};
+
+    double pnl = 0.0;
+};
+
+} // namespace phoenix::triangular
@@ -11,6 +11,8 @@ struct Risk : NodeBase
 
     void handle(tag::Risk::Abort)
     {
+        this->getHandler()->invoke(tag::FlightRecorder::Dump{}, "Risk::Abort");
+        this->getHandler()->invoke(tag::ExchangeLatency::Report{});
         this->getHandler()->invoke(tag::Stream::Stop{});
         this->getHandler()->invoke(tag::Logger::Stop{});
         std::abort();
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "phoenix/common/book_manager.hpp"
+#include "phoenix/common/exchange_latency.hpp"
+#include "phoenix/common/flight_recorder.hpp"
+#include "phoenix/common/gateway_client.hpp"
+#include "phoenix/common/logger.hpp"
+#include "phoenix/common/perf_counters.hpp"
+#include "phoenix/common/profiler.hpp"
+#include "phoenix/common/scheduler.hpp"
+#include "phoenix/common/tcp_socket.hpp"
+#include "phoenix/graph/router.hpp"
+#include "phoenix/strategies/triangular/config.hpp"
+#include "phoenix/strategies/triangular/hitter.hpp"
+#include "phoenix/strategies/triangular/risk.hpp"
+#include "phoenix/strategies/triangular/stream.hpp"
+#include "phoenix/utils.hpp"
+
+#include <string_view>
+
+namespace phoenix::triangular {
+
+// clang-format off
+template<typename Traits, template<typename> class HitterNode>
+using Graph = Router<
+    Config<Traits>,
+    Traits,
+    NodeList<
+        TCPSocket,
+        Scheduler,
+        GatewayClient,
+        Stream,
+        BookManager,
+        ExchangeLatency,
+        HitterNode,
+        Risk,
+        Logger,
+        Profiler,
+        PerfCounters,
+        FlightRecorder
+    >
+>;
+// clang-format on
+
+// The whole main of a triangular binary, only the Traits (and the hitter) differ between them
+template<typename Traits, template<typename> class HitterNode = Hitter>
+int run(int argc, char* argv[], std::string_view name)
+{
+    Config<Traits> config;
+    if (!config.apply(argc, argv))
+        return 1;
+
+    Graph<Traits, HitterNode> graph{config};
+    auto* handler = graph.getHandler();
+
+    handler->invoke(tag::Logger::Start{});
+    handler->invoke(tag::FlightRecorder::Start{});
+    handler->invoke(tag::BookManager::Start{});
+    PHOENIX_LOG_INFO(handler, "Starting", name, "Arbitrage System");
+
+    setMaxThreadPriority();
+    handler->invoke(tag::Stream::Start{});
+    return 0;
+}
+
+} // namespace phoenix::triangular
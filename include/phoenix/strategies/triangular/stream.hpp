@@ -1,15 +1,19 @@
 #pragma once
 
+#include "phoenix/common/exchange_latency.hpp"
 #include "phoenix/common/logger.hpp"
+#include "phoenix/common/perf_counters.hpp"
 #include "phoenix/common/profiler.hpp"
 #include "phoenix/data/fix.hpp"
 #include "phoenix/data/orders.hpp"
 #include "phoenix/tools/fix_circular_buffer.hpp"
+#include "phoenix/tools/tracepoints.hpp"
 #include "phoenix/tags.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/regex.hpp>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cstdint>
@@ -40,13 +44,18 @@ struct Stream : NodeBase
     {
         auto logoutMsg = fixBuilder.logout(nextSeqNum);
         isRunning = false;
+        this->getHandler()->invoke(tag::PerfCounters::Report{});
         this->getHandler()->invoke(tag::TCPSocket::Stop{}, logoutMsg);
     }
 
     void handle(tag::Stream::Start)
     {
+        auto* handler = this->getHandler();
         auto* config = this->getConfig();
-        this->getHandler()->invoke(tag::TCPSocket::Connect{}, config->host, config->port, config->colo); 
+        handler->invoke(tag::Gateway::Start{});
+        isGateway = handler->retrieve(tag::Gateway::IsEnabled{});
+
+        handler->invoke(tag::TCPSocket::Connect{}, config->host, config->port, config->colo); 
         login();
         isRunning = true;
 
@@ -58,12 +67,21 @@ struct Stream : NodeBase
     inline bool handle(tag::Stream::TakeMarketOrders, Orders&&... orders)
     {
         auto* handler = this->getHandler();
+        if (isGateway)
+            return handler->retrieve(tag::Gateway::Submit{}, Priority::HEDGE, OrderAction::NEW, orders...);
+
         if (!handler->retrieve(tag::TCPSocket::CheckThrottle{}, sizeof...(Orders)))
             return false;
 
         auto const sendOrder = [&](auto const& order)
         {
-            auto msg = fixBuilder.newOrderSingle(nextSeqNum, order.symbol, order);
+            std::string_view msg;
+            {
+                [[maybe_unused]] auto counters = handler->retrieve(tag::PerfCounters::Guard{}, "encode");
+                msg = fixBuilder.newOrderSingle(nextSeqNum, order.symbol, order);
+            }
+
+            [[maybe_unused]] auto counters = handler->retrieve(tag::PerfCounters::Guard{}, "send");
             handler->invoke(tag::TCPSocket::SendUnthrottled{}, msg);
             ++nextSeqNum;
         };
@@ -96,6 +114,41 @@ struct Stream : NodeBase
         return success;
     }
 
+    // a message of the Scheduler, false without the credits for it, or while the gateway holds it back
+    [[gnu::hot, gnu::always_inline]]
+    inline bool handle(tag::Stream::Release, Priority priority, OrderAction action, auto const& order)
+    {
+        auto* handler = this->getHandler();
+        if (isGateway)
+            return handler->retrieve(tag::Gateway::Submit{}, priority, action, order);
+
+        if (!handler->retrieve(tag::TCPSocket::CheckThrottle{}, 1u))
+            return false;
+
+        std::string_view msg;
+        switch (action)
+        {
+        case OrderAction::NEW: msg = fixBuilder.newOrderSingle(nextSeqNum, order.symbol, order); break;
+        case OrderAction::REPLACE: msg = fixBuilder.orderCancelReplaceRequest(nextSeqNum, order.symbol, order); break;
+        case OrderAction::CANCEL: msg = fixBuilder.orderCancelRequest(nextSeqNum, order.symbol, order.orderId, order.clOrdId); break;
+        }
+
+        handler->invoke(tag::TCPSocket::SendUnthrottled{}, msg);
+        ++nextSeqNum;
+        return true;
+    }
+
+    // a reply to a TestRequest with its TestReqID
+    inline bool handle(tag::Stream::SendHeartbeat, std::string_view testReqId)
+    {
+        auto msg = testReqId.empty() ? fixBuilder.heartbeat(nextSeqNum) : fixBuilder.heartbeat(nextSeqNum, testReqId);
+        bool const success = this->getHandler()->retrieve(tag::TCPSocket::Send{}, msg);
+        if (success) [[likely]]
+            ++nextSeqNum;
+
+        return success;
+    }
+
 private:
     void startPipeline()
     {
@@ -107,18 +160,20 @@ private:
 
         PHOENIX_LOG_INFO(handler, "Starting trading pipeline");
 
+        handler->invoke(tag::Hitter::Subscribe{});
+
         // initializing snapshots
         for (auto const& instrument : instrumentList)
             getSnapshot(instrument);
 
-        unsigned int i = 0u;
-        while (i < 3u)
+        std::size_t i = 0u;
+        while (i < instrumentList.size())
         {
             auto msg = handler->retrieve(tag::TCPSocket::ForceReceive{});
             fixReader.init(msg);
             if (fixReader.isMessageType("W"))
             {
-                handler->invoke(tag::Hitter::MDUpdate{}, fixReader, false);
+                handler->invoke(tag::BookManager::Apply{}, fixReader, false);
                 ++i;
             }
             else
@@ -128,53 +183,47 @@ private:
         // subscribing to incremental
         subscribeToAll(instrumentList);
 
+        bool const conflate = config->mdConflation;
+        if (conflate)
+            handler->invoke(tag::BookManager::Flush{});
+
         while (isRunning)
         {
             try
             {
                 if (std::chrono::steady_clock::now() - heartbeatLastSent > HEARTBEAT_INTERVAL) [[unlikely]]
                 {
-                    auto msg = fixBuilder.heartbeat(nextSeqNum);
-                    handler->invoke(tag::TCPSocket::ForceSend{}, msg);
-                    ++nextSeqNum;
+                    handler->invoke(tag::Scheduler::Heartbeat{});
                     heartbeatLastSent = std::chrono::steady_clock::now();
+
+                    if (conflate)
+                        logBacklog();
+
+                    handler->invoke(tag::ExchangeLatency::Report{});
+                    handler->invoke(tag::PerfCounters::Report{});
                 }
 
+                // receiving blocks, so while messages wait for credits, or reports may come from the gateway,
+                // only what has already arrived is read
+                handler->invoke(tag::Scheduler::Tick{});
+                if (isGateway)
+                {
+                    while (auto report = handler->retrieve(tag::Gateway::Receive{}))
+                        process(*report, true);
+                }
+
+                bool const mustPoll = isGateway || handler->retrieve(tag::Scheduler::GetQueued{});
+                if (mustPoll && !handler->retrieve(tag::TCPSocket::Available{}))
+                    continue;
+
                 auto msgOpt = handler->retrieve(tag::TCPSocket::Receive{});
                 if (!msgOpt)
                     continue;
 
                 /*[[maybe_unused]] auto profiler = handler->retrieve(tag::Profiler::Guard{}, "Trading pipeline");*/
-                fixReader.init(*msgOpt);
-                auto msgType = fixReader.getMessageType();
-
-                switch (msgType[0])
-                {
-                    case '1':
-                    {
-                        auto msg = fixBuilder.heartbeat(nextSeqNum, fixReader.getStringView(112));
-                        handler->invoke(tag::TCPSocket::ForceSend{}, msg);
-                        ++nextSeqNum;
-                        PHOENIX_LOG_INFO(handler, "Received TestRequest, sending Heartbeat");
-                        continue;
-                    }
-                    case 'X':
-                    case 'W':
-                    {
-                        handler->invoke(tag::Hitter::MDUpdate{}, fixReader, true);
-                        continue;
-                    }
-                    case '8':
-                    {
-                        handler->invoke(tag::Hitter::ExecutionReport{}, fixReader);
-                        continue;
-                    }
-                    case '0':
-                        continue;
-                    default:
-                        PHOENIX_LOG_ERROR(handler, "Unknown message type", msgType);
-                        break;
-                }
+                process(*msgOpt, !conflate);
+                if (conflate)
+                    drain();
             }
             catch (std::exception const& e)
             {
@@ -184,23 +233,122 @@ private:
         }
     }
 
+    // Market data only notifies the hitter with notify, otherwise it waits for the next flush
+    [[gnu::hot, gnu::always_inline]]
+    inline void process(std::string_view msg, bool const notify)
+    {
+        auto* handler = this->getHandler();
+        {
+            [[maybe_unused]] auto counters = handler->retrieve(tag::PerfCounters::Guard{}, "parse");
+            fixReader.init(msg);
+        }
+
+        auto msgType = fixReader.getMessageType();
+        PHOENIX_TRACE(parse, msg.size());
+
+        switch (msgType[0])
+        {
+            case '1':
+            {
+                handler->invoke(tag::Scheduler::Heartbeat{}, fixReader.getStringView(112));
+                PHOENIX_LOG_INFO(handler, "Received TestRequest, Heartbeat scheduled");
+                break;
+            }
+            case 'X':
+            case 'W':
+            {
+                handler->invoke(tag::BookManager::Apply{}, fixReader, notify);
+                break;
+            }
+            case '8':
+            {
+                PHOENIX_TRACE(exec_report, msg.data(), msg.size());
+                handler->retrieve(tag::ExchangeLatency::Record{}, EXECUTION_REPORT_STREAM, fixReader.getStringView(52));
+                handler->invoke(tag::Hitter::ExecutionReport{}, fixReader);
+                break;
+            }
+            case '0':
+                break;
+            default:
+                PHOENIX_LOG_ERROR(handler, "Unknown message type", msgType);
+                break;
+        }
+    }
+
+    // Takes what was already received behind the first message, execution reports still go through in order
+    // Triggers then run once per changed instrument on the latest book instead of once per stale update
+    // Only the backlog seen on entry is taken, at most MAX_DRAIN_FRAMES of it, so a feed faster than we parse still flushes
+    [[gnu::hot]]
+    void drain()
+    {
+        auto* handler = this->getHandler();
+        std::size_t const backlogBytes = handler->retrieve(tag::TCPSocket::Available{});
+        std::size_t drainedBytes = 0u;
+        std::size_t frames = 1u;
+
+        // Receive blocks on a partial message, so what's left is checked on every frame
+        while (drainedBytes < backlogBytes && frames < MAX_DRAIN_FRAMES && handler->retrieve(tag::TCPSocket::Available{}))
+        {
+            auto msgOpt = handler->retrieve(tag::TCPSocket::Receive{});
+            if (!msgOpt)
+                break;
+
+            process(*msgOpt, false);
+            drainedBytes += msgOpt->size();
+            ++frames;
+        }
+
+        PHOENIX_TRACE(md_batch, frames, backlogBytes);
+        backlog.frames += frames;
+        ++backlog.batches;
+        backlog.maxFrames = std::max(backlog.maxFrames, frames);
+        backlog.maxBytes = std::max(backlog.maxBytes, backlogBytes);
+
+        handler->invoke(tag::BookManager::Flush{});
+    }
+
+    void logBacklog()
+    {
+        auto* handler = this->getHandler();
+        std::uint64_t const conflated = handler->retrieve(tag::BookManager::GetConflated{});
+        PHOENIX_LOG_INFO(
+            handler,
+            "[BACKLOG] batches",
+            backlog.batches,
+            "frames",
+            backlog.frames,
+            "max frames",
+            backlog.maxFrames,
+            "max bytes",
+            backlog.maxBytes,
+            "conflated updates",
+            conflated);
+
+        // maxima are per heartbeat interval
+        backlog.maxFrames = 0u;
+        backlog.maxBytes = 0u;
+    }
+
     void getSnapshot(std::string_view instrument)
     {
-        std::string_view const msg = fixBuilder.marketDataRequestTopLevel(nextSeqNum, instrument);
+        unsigned const depth = this->getConfig()->bookDepth;
+        std::string_view const msg = fixBuilder.marketDataRequestTopLevel(nextSeqNum, instrument, depth);
         this->getHandler()->invoke(tag::TCPSocket::ForceSend{}, msg);
         ++nextSeqNum;
     }
 
     void subscribeToOne(std::string_view instrument)
     {
-        std::string_view const msg = fixBuilder.marketDataRefreshSingle(nextSeqNum, instrument);
+        unsigned const depth = this->getConfig()->bookDepth;
+        std::string_view const msg = fixBuilder.marketDataRefreshSingle(nextSeqNum, instrument, depth);
         this->getHandler()->invoke(tag::TCPSocket::ForceSend{}, msg);
         ++nextSeqNum;
     }
 
     void subscribeToAll(std::vector<std::string> const& instruments)
     {
-        std::string_view const msg = fixBuilder.marketDataRefreshTriple(nextSeqNum, instruments);
+        unsigned const depth = this->getConfig()->bookDepth;
+        std::string_view const msg = fixBuilder.marketDataRefreshTriple(nextSeqNum, instruments, depth);
         this->getHandler()->invoke(tag::TCPSocket::ForceSend{}, msg);
         ++nextSeqNum;
     }
@@ -220,11 +368,22 @@ private:
         PHOENIX_LOG_INFO(handler, "Login successful");
     }
 
+    struct Backlog
+    {
+        std::uint64_t batches = 0u;
+        std::uint64_t frames = 0u;
+        std::size_t maxFrames = 0u;
+        std::size_t maxBytes = 0u;
+    };
+
     bool isRunning = false;
+    bool isGateway = false;
     std::size_t nextSeqNum = 1u;
+    Backlog backlog;
     FIXMessageBuilder fixBuilder;
     FIXReaderFast fixReader;
     static constexpr std::chrono::seconds HEARTBEAT_INTERVAL{80u};
+    static constexpr std::size_t MAX_DRAIN_FRAMES{256u};
     std::chrono::steady_clock::time_point heartbeatLastSent = std::chrono::steady_clock::now();
 };
 
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace phoenix::triangular {
+
+// How the Hitter sizes a triangle before it trades
+enum class Sizing
+{
+    FIXED, // volume-size on the first leg, whatever the books show
+    TOP,   // volume-size capped by the touch quantity of every leg
+    BOOK   // swept against the books, every leg shrinks to the shortest one once, FOK at the worst swept price
+};
+
+// One leg of a triangle, in the order of the instrument list
+struct Leg
+{
+    // The product of every leg price to its exponent is 1 without an edge, e.g. BTC_USDT^-1 * BTC_USDC * USDC_USDT
+    int exponent;
+
+    // Leg whose volume this one trades, converted by notional (its price over this price) or taken as is
+    std::size_t volumeOf = 0u;
+    bool byNotional = false;
+
+    // Converted volumes are rounded to whole lots, 0 for none
+    double lotSize = 0.0;
+
+    // Touch quantity needed on the side the leg trades
+    double minQty = 0.0;
+
+    // Updates of this leg evaluate the triangle
+    bool triggers = true;
+};
+
+// Compile time description of a triangle, given to the Hitter as Traits::TRIANGLE
+// Case 1 sells the legs with a positive exponent and buys the others, case 2 is the reverse
+template<std::size_t N>
+struct Triangle
+{
+    std::array<Leg, N> legs;
+    Sizing sizing = Sizing::FIXED;
+
+    // Leg alone on its side of the identity, the PnL is the price difference times its volume
+    std::size_t pnlLeg = 0u;
+    std::string_view pnlCurrency;
+
+    consteval bool isValid() const
+    {
+        if (legs[0].volumeOf != 0u || pnlLeg >= N)
+            return false;
+
+        for (std::size_t i = 0u; i < N; ++i)
+        {
+            if ((legs[i].exponent != 1 && legs[i].exponent != -1) || legs[i].volumeOf > i)
+                return false;
+
+            if (legs[i].volumeOf == i && i != 0u)
+                return false;
+        }
+
+        return true;
+    }
+};
+
+} // namespace phoenix::triangular
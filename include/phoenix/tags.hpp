@@ -19,6 +19,15 @@ struct Stream
     struct CancelQuote
     {};
 
+    struct SendBatch
+    {};
+
+    struct Release
+    {};
+
+    struct SendHeartbeat
+    {};
+
     struct GetBalance
     {};
 };
@@ -34,6 +43,12 @@ struct Logger
     struct Log
     {};
 
+    struct IsEnabled
+    {};
+
+    struct Dropped
+    {};
+
     struct Verify
     {};
 
@@ -47,6 +62,33 @@ struct Profiler
     {};
 };
 
+struct PerfCounters
+{
+    struct Guard
+    {};
+
+    struct Report
+    {};
+};
+
+struct FlightRecorder
+{
+    struct Start
+    {};
+
+    struct Inbound
+    {};
+
+    struct Outbound
+    {};
+
+    struct Decision
+    {};
+
+    struct Dump
+    {};
+};
+
 struct Quoter
 {
     struct MDUpdate
@@ -54,11 +96,14 @@ struct Quoter
 
     struct ExecutionReport
     {};
+
+    struct CancelReject
+    {};
 };
 
 struct Hitter
 {
-    struct MDUpdate
+    struct Subscribe
     {};
 
     struct ExecutionReport
@@ -68,6 +113,114 @@ struct Hitter
     {};
 };
 
+struct BookManager
+{
+    struct Start
+    {};
+
+    struct Intern
+    {};
+
+    struct Subscribe
+    {};
+
+    struct Apply
+    {};
+
+    struct Changed
+    {};
+
+    struct Flush
+    {};
+
+    struct GetConflated
+    {};
+
+    struct GetBook
+    {};
+
+    struct GetTop
+    {};
+};
+
+struct ExchangeLatency
+{
+    struct Name
+    {};
+
+    struct Record
+    {};
+
+    struct IsStale
+    {};
+
+    struct Report
+    {};
+};
+
+struct Scheduler
+{
+    struct Submit
+    {};
+
+    struct Heartbeat
+    {};
+
+    struct Tick
+    {};
+
+    struct GetQueued
+    {};
+
+    struct IsQueued
+    {};
+
+    struct HasQueued
+    {};
+};
+
+struct Gateway
+{
+    struct Start
+    {};
+
+    struct IsEnabled
+    {};
+
+    struct Submit
+    {};
+
+    struct SubmitBatch
+    {};
+
+    struct Receive
+    {};
+};
+
+struct SessionPool
+{
+    struct Start
+    {};
+
+    struct Stop
+    {};
+
+    struct GetSize
+    {};
+
+    struct Send
+    {};
+
+    struct SendBatch
+    {};
+
+    struct Heartbeat
+    {};
+
+    struct Receive
+    {};
+};
+
 struct Risk
 {
     struct Abort
@@ -100,6 +253,9 @@ struct TCPSocket
     struct ForceReceive
     {};
 
+    struct Available
+    {};
+
     struct CheckThrottle
     {};
 
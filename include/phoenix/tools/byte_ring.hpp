@@ -0,0 +1,157 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace phoenix {
+
+// Single-producer single-consumer ring of variable sized records
+// Records are contiguous in memory (a padding record is inserted at the wrap point)
+// and 8 byte aligned, so the consumer can read them in place
+struct ByteRing
+{
+    explicit ByteRing(std::size_t capacity)
+        : capacity{capacity}
+        , mask{capacity - 1u}
+        , buffer{new std::byte[capacity]}
+    {
+        assert((capacity & mask) == 0u && "Capacity must be a power of two");
+        std::memset(buffer.get(), 0, capacity); // prefault
+    }
+
+    ByteRing(ByteRing const&) = delete;
+    ByteRing& operator=(ByteRing const&) = delete;
+
+    // producer: returns space for size bytes, or nullptr if the ring is full
+    // headroom bytes are left free for later records (e.g. for ones with a higher priority)
+    [[gnu::hot, gnu::always_inline]]
+    inline std::byte* reserve(std::size_t size, std::size_t headroom = 0u)
+    {
+        std::size_t const total = recordSize(size);
+        std::size_t const position = producer.head;
+        std::size_t const offset = position & mask;
+        std::size_t const contiguous = capacity - offset;
+        std::size_t const needed = total <= contiguous ? total : contiguous + total;
+
+        if (position + needed + headroom - producer.cachedTail > capacity)
+        {
+            producer.cachedTail = tail.load(std::memory_order_acquire);
+            if (position + needed + headroom - producer.cachedTail > capacity)
+                return nullptr;
+        }
+
+        std::size_t start = position;
+        if (total > contiguous) [[unlikely]]
+        {
+            writeHeader(offset, contiguous, true);
+            start += contiguous;
+        }
+
+        producer.pending = start + total;
+        writeHeader(start & mask, total, false);
+        return buffer.get() + (start & mask) + HEADER_SIZE;
+    }
+
+    // producer: publishes the last reserved record
+    [[gnu::hot, gnu::always_inline]]
+    inline void commit()
+    {
+        producer.head = producer.pending;
+        head.store(producer.head, std::memory_order_release);
+    }
+
+    // producer: true once the consumer has released every committed record
+    inline bool isDrained()
+    {
+        producer.cachedTail = tail.load(std::memory_order_acquire);
+        return producer.cachedTail == producer.head;
+    }
+
+    // consumer: next record payload, or nullptr if empty
+    [[gnu::hot, gnu::always_inline]]
+    inline std::byte const* front()
+    {
+        while (true)
+        {
+            if (consumer.tail == consumer.cachedHead)
+            {
+                consumer.cachedHead = head.load(std::memory_order_acquire);
+                if (consumer.tail == consumer.cachedHead)
+                    return nullptr;
+            }
+
+            Header header;
+            std::memcpy(&header, buffer.get() + (consumer.tail & mask), HEADER_SIZE);
+            if (!header.isPadding) [[likely]]
+                return buffer.get() + (consumer.tail & mask) + HEADER_SIZE;
+
+            consumer.tail += header.size;
+            tail.store(consumer.tail, std::memory_order_release);
+        }
+    }
+
+    // consumer: releases the record returned by front()
+    [[gnu::hot, gnu::always_inline]]
+    inline void pop()
+    {
+        Header header;
+        std::memcpy(&header, buffer.get() + (consumer.tail & mask), HEADER_SIZE);
+        consumer.tail += header.size;
+        tail.store(consumer.tail, std::memory_order_release);
+    }
+
+    // consumer view, exact only when called from the consumer thread
+    bool empty() const { return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire); }
+
+    // largest payload that can ever fit
+    std::size_t maxPayload() const { return capacity / 2u - HEADER_SIZE; }
+    std::size_t getCapacity() const { return capacity; }
+
+private:
+    struct Header
+    {
+        std::uint32_t size;
+        std::uint32_t isPadding;
+    };
+
+    static constexpr std::size_t HEADER_SIZE = sizeof(Header);
+    static constexpr std::size_t ALIGNMENT = 8u;
+    static constexpr std::size_t CACHE_LINE_SIZE = 64u;
+
+    static constexpr std::size_t recordSize(std::size_t payload)
+    {
+        return (payload + HEADER_SIZE + ALIGNMENT - 1u) & ~(ALIGNMENT - 1u);
+    }
+
+    inline void writeHeader(std::size_t offset, std::size_t size, bool isPadding)
+    {
+        Header const header{static_cast<std::uint32_t>(size), isPadding};
+        std::memcpy(buffer.get() + offset, &header, HEADER_SIZE);
+    }
+
+    std::size_t const capacity;
+    std::size_t const mask;
+    std::unique_ptr<std::byte[]> buffer;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head{0u};
+    alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail{0u};
+
+    struct alignas(CACHE_LINE_SIZE)
+    {
+        std::size_t head = 0u;
+        std::size_t pending = 0u;
+        std::size_t cachedTail = 0u;
+    } producer;
+
+    struct alignas(CACHE_LINE_SIZE)
+    {
+        std::size_t tail = 0u;
+        std::size_t cachedHead = 0u;
+    } consumer;
+};
+
+} // namespace phoenix
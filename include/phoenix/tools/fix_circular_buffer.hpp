@@ -15,6 +15,12 @@ struct FIXCircularBuffer
     boost::asio::mutable_buffer getAsioBuffer();
     std::optional<std::string_view> getMsg(std::size_t bytesRead);
 
+    // a whole message is buffered, so getMsg(0u) returns it without reading the socket
+    bool hasMsg() const;
+
+    // received bytes not handed out yet
+    std::size_t getSize() const { return end - start; }
+
 private:
     void advanceMoveOverflow(std::size_t newStart, std::size_t newEnd);
 
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "phoenix/tools/fix_circular_buffer.hpp"
+#include "phoenix/tools/token_bucket.hpp"
+#include "phoenix/tools/tracepoints.hpp"
+
+#include <boost/asio.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace phoenix {
+
+// One FIX connection to the exchange and the rate limit of the account behind it
+// The TCPSocket holds the one of the main account, the SessionPool one per subaccount, Deribit gives each its own credits
+// Errors are handed back, the node owning the session logs them
+struct FIXSession
+{
+    // throttling, in Deribit's credits, 5 messages of burst refilled at 5 a second
+    static constexpr std::uint64_t CREDITS_PER_MESSAGE{500u};
+    static constexpr std::uint64_t MAX_CREDITS{2'500u};
+    static constexpr std::uint64_t CREDITS_PER_SECOND{2'500u};
+
+    explicit FIXSession(boost::asio::io_context& ioContext)
+        : socket{ioContext}
+    {}
+
+    // throws like asio on failure, colo connects to the address as it is, otherwise host is resolved
+    void connect(boost::asio::io_context& ioContext, std::string const& host, std::string const& portStr, bool isColo);
+
+    void close(boost::system::error_code& error) { socket.close(error); }
+
+    // every message costs CREDITS_PER_MESSAGE of the bucket, a batch goes out whole or not at all
+    [[gnu::hot, gnu::always_inline]]
+    inline bool checkThrottle(std::size_t numMessages)
+    {
+        if (!credits.tryTake(numMessages * CREDITS_PER_MESSAGE)) [[unlikely]]
+        {
+            PHOENIX_TRACE(throttle_reject, numMessages, credits.getCredits());
+            return false;
+        }
+
+        return true;
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void sendUnthrottled(std::string_view msg, boost::system::error_code& error)
+    {
+        PHOENIX_TRACE(order_send, msg.data(), msg.size());
+        boost::asio::write(socket, boost::asio::buffer(msg), error);
+    }
+
+    // a message left in the buffer first, then a read that blocks unless asked not to, a partial message stays buffered
+    [[gnu::hot, gnu::always_inline]]
+    inline std::optional<std::string_view> receive(boost::system::error_code& error, bool isBlocking = true)
+    {
+        auto msg = circularBuffer.getMsg(0u);
+        if (!msg)
+        {
+            if (!isBlocking && !socket.available(error))
+                return std::nullopt;
+
+            auto bytesRead = socket.read_some(circularBuffer.getAsioBuffer(), error);
+            if (error)
+                return std::nullopt;
+
+            msg = circularBuffer.getMsg(bytesRead);
+        }
+
+        if (msg)
+            PHOENIX_TRACE(receive, msg->data(), msg->size());
+
+        return msg;
+    }
+
+    // bytes receive can take without blocking, a partial message left in the buffer doesn't count
+    [[gnu::hot, gnu::always_inline]]
+    inline std::size_t available(boost::system::error_code& error)
+    {
+        std::size_t const pending = socket.available(error);
+        return pending + (circularBuffer.hasMsg() ? circularBuffer.getSize() : 0u);
+    }
+
+private:
+    static constexpr int SOCKET_PRIORITY{6};
+    static constexpr int SOCKET_ENABLE_FLAG{1};
+    static constexpr int SOCKET_POLL_MICROSECONDS{10000};
+
+    boost::asio::ip::tcp::socket socket;
+    FIXCircularBuffer circularBuffer;
+    TokenBucket credits{MAX_CREDITS, CREDITS_PER_SECOND};
+};
+
+} // namespace phoenix
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace phoenix {
+
+// Inline string of at most CAPACITY chars, copying or assigning it never allocates
+// Longer values are cut to CAPACITY, wasTruncated() tells the caller about it
+template<std::size_t CAPACITY>
+struct FixedString
+{
+    static_assert(CAPACITY <= UINT8_MAX);
+
+    constexpr FixedString() = default;
+    constexpr FixedString(std::string_view value) { assign(value); }
+
+    constexpr FixedString& operator=(std::string_view value)
+    {
+        assign(value);
+        return *this;
+    }
+
+    constexpr void assign(std::string_view value)
+    {
+        size = static_cast<std::uint8_t>(std::min(value.size(), CAPACITY));
+        truncated = value.size() > CAPACITY;
+        std::copy_n(value.data(), size, chars.data());
+    }
+
+    constexpr void clear()
+    {
+        size = 0u;
+        truncated = false;
+    }
+
+    constexpr std::string_view view() const { return {chars.data(), size}; }
+    constexpr operator std::string_view() const { return view(); }
+
+    constexpr bool empty() const { return !size; }
+    constexpr std::size_t getSize() const { return size; }
+    constexpr bool wasTruncated() const { return truncated; }
+
+    friend constexpr bool operator==(FixedString const& lhs, std::string_view rhs) { return lhs.view() == rhs; }
+
+private:
+    std::array<char, CAPACITY> chars{};
+    std::uint8_t size = 0u;
+    bool truncated = false;
+};
+
+} // namespace phoenix
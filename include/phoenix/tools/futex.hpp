@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace phoenix {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+
+// Sleeps while word == expected, for at most timeoutNs (spurious wakeups are possible)
+inline void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected, long timeoutNs)
+{
+    timespec const timeout{.tv_sec = timeoutNs / 1'000'000'000, .tv_nsec = timeoutNs % 1'000'000'000};
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, &timeout, nullptr, 0);
+}
+
+inline void futexWakeOne(std::atomic<std::uint32_t>& word)
+{
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+} // namespace phoenix
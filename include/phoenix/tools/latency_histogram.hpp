@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace phoenix {
+
+// Log-linear histogram of nanosecond latencies, 8 buckets per power of two so any value is within 12.5%
+// Fixed size and never allocates, recording is a bit scan and an increment
+struct LatencyHistogram
+{
+    static constexpr std::size_t SUB_BUCKETS = 8u;
+    static constexpr std::size_t SUB_BITS = 3u;
+    static constexpr std::size_t NUM_BUCKETS = SUB_BUCKETS + (64u - SUB_BITS) * SUB_BUCKETS;
+
+    // negative values (clock skew between the exchange and us) are counted as 0
+    [[gnu::hot, gnu::always_inline]]
+    inline void record(std::int64_t value)
+    {
+        if (value < 0) [[unlikely]]
+        {
+            ++numNegative;
+            value = 0;
+        }
+
+        auto const v = static_cast<std::uint64_t>(value);
+        ++buckets[getBucket(v)];
+        ++count;
+        sum += v;
+        max = v > max ? v : max;
+    }
+
+    // upper bound of the bucket holding the quantile, q in [0, 1]
+    std::uint64_t getQuantile(double q) const;
+
+    std::uint64_t getCount() const { return count; }
+    std::uint64_t getNumNegative() const { return numNegative; }
+    std::uint64_t getMax() const { return max; }
+    double getMean() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+
+    static std::uint64_t getBucketLowerBound(std::size_t bucket);
+    std::uint64_t getBucketCount(std::size_t bucket) const { return buckets[bucket]; }
+
+    void reset();
+
+private:
+    [[gnu::always_inline]]
+    static inline std::size_t getBucket(std::uint64_t value)
+    {
+        if (value < SUB_BUCKETS)
+            return value;
+
+        std::size_t const msb = std::bit_width(value) - 1u;
+        std::size_t const sub = (value >> (msb - SUB_BITS)) & (SUB_BUCKETS - 1u);
+        return SUB_BUCKETS + (msb - SUB_BITS) * SUB_BUCKETS + sub;
+    }
+
+    std::array<std::uint64_t, NUM_BUCKETS> buckets{};
+    std::uint64_t count = 0u;
+    std::uint64_t numNegative = 0u;
+    std::uint64_t sum = 0u;
+    std::uint64_t max = 0u;
+};
+
+} // namespace phoenix
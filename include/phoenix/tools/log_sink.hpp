@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <streambuf>
+#include <string_view>
+
+namespace phoenix {
+
+// Buffered file sink for the logger thread
+// Entries are formatted straight into a large aligned buffer which is written out with one write() per batch,
+// only when it is full or on flush()
+struct LogSink : std::streambuf
+{
+    static constexpr std::size_t DEFAULT_CAPACITY = 1u << 20u;
+    static constexpr std::size_t TIMESTAMP_LENGTH = 30u; // 2024-01-01T00:00:00.000000000Z
+
+    explicit LogSink(std::size_t capacity = DEFAULT_CAPACITY);
+    ~LogSink() override;
+
+    LogSink(LogSink const&) = delete;
+    LogSink& operator=(LogSink const&) = delete;
+
+    // returns errno on failure, 0 on success
+    int open(char const* path);
+
+    // writes to an fd owned by someone else, e.g. STDOUT_FILENO
+    void attach(int fd);
+
+    bool isOpen() const { return fd >= 0; }
+
+    void flush();
+    void close();
+
+    // ISO 8601 UTC with nanoseconds, the date and time are only formatted again when the second changes
+    [[gnu::hot, gnu::always_inline]]
+    inline void appendTimestamp(std::int64_t ns)
+    {
+        std::int64_t const seconds = ns / 1'000'000'000;
+        if (seconds != cachedSecond) [[unlikely]]
+            formatSecond(seconds);
+
+        char out[TIMESTAMP_LENGTH];
+        std::memcpy(out, secondPrefix, SECOND_PREFIX_LENGTH);
+
+        auto nanos = static_cast<std::uint32_t>(ns - seconds * 1'000'000'000);
+        for (std::size_t i = SECOND_PREFIX_LENGTH + 9u; i > SECOND_PREFIX_LENGTH; --i)
+        {
+            out[i - 1u] = static_cast<char>('0' + nanos % 10u);
+            nanos /= 10u;
+        }
+
+        out[TIMESTAMP_LENGTH - 1u] = 'Z';
+        append({out, TIMESTAMP_LENGTH});
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void append(std::string_view text)
+    {
+        xsputn(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void append(char c)
+    {
+        sputc(c);
+    }
+
+protected:
+    int_type overflow(int_type c) override;
+    int sync() override;
+
+private:
+    static constexpr std::size_t SECOND_PREFIX_LENGTH = 20u; // 2024-01-01T00:00:00.
+    static constexpr std::size_t BUFFER_ALIGNMENT = 4096u;
+
+    struct FreeBuffer
+    {
+        void operator()(char* buffer) const;
+    };
+
+    void formatSecond(std::int64_t seconds);
+
+    std::size_t const capacity;
+    std::unique_ptr<char, FreeBuffer> buffer;
+
+    int fd = -1;
+    bool ownsFd = false;
+
+    std::int64_t cachedSecond = -1;
+    char secondPrefix[SECOND_PREFIX_LENGTH];
+};
+
+} // namespace phoenix
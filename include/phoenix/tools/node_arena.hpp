@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace phoenix {
+
+// Fixed size node storage with an intrusive free list, allocate and deallocate are a pointer swap
+// Nodes are carved out of chunks that are never moved or released before the arena, so growing keeps nodes valid
+// The node size is fixed by the first allocation
+struct NodeArena
+{
+    static constexpr std::size_t DEFAULT_CHUNK_NODES = 4096u;
+    static constexpr std::size_t NODE_ALIGNMENT = alignof(std::max_align_t);
+
+    explicit NodeArena(bool hugePages = false, std::size_t chunkNodes = DEFAULT_CHUNK_NODES);
+    ~NodeArena();
+
+    NodeArena(NodeArena const&) = delete;
+    NodeArena& operator=(NodeArena const&) = delete;
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void* allocate(std::size_t size)
+    {
+        if (!freeList) [[unlikely]]
+            grow(size);
+
+        assert(size <= nodeSize && "NodeArena only serves one node size");
+
+        FreeNode* node = freeList;
+        freeList = node->next;
+        ++numLive;
+        return node;
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void deallocate(void* ptr)
+    {
+        auto* node = static_cast<FreeNode*>(ptr);
+        node->next = freeList;
+        freeList = node;
+        --numLive;
+    }
+
+    std::size_t getCapacity() const { return capacity; }
+    std::size_t getNumLive() const { return numLive; }
+    std::size_t getNumChunks() const { return chunks.size(); }
+
+    // false when huge pages were requested but the kernel had none to give
+    bool usesHugePages() const { return hugePagesUsed; }
+
+private:
+    static constexpr std::size_t HUGE_PAGE_SIZE = 2u << 20u;
+
+    struct FreeNode
+    {
+        FreeNode* next;
+    };
+
+    struct Chunk
+    {
+        void* memory;
+        std::size_t bytes;
+    };
+
+    // Slow path, maps a new chunk and threads its nodes onto the free list
+    [[gnu::cold, gnu::noinline]]
+    void grow(std::size_t size);
+
+    FreeNode* freeList = nullptr;
+    std::size_t nodeSize = 0u;
+    std::size_t numLive = 0u;
+    std::size_t capacity = 0u;
+
+    std::size_t const chunkNodes;
+    bool const hugePages;
+    bool hugePagesUsed = false;
+    std::vector<Chunk> chunks;
+};
+
+} // namespace phoenix
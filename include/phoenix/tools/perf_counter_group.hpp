@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include <linux/perf_event.h>
+#include <unistd.h>
+#include <x86intrin.h>
+
+namespace phoenix {
+
+// Hardware counters for the calling thread, read from user space with rdpmc
+// Falls back to read() per counter if the kernel doesn't allow rdpmc (see /proc/sys/kernel/perf_user_access)
+struct PerfCounterGroup
+{
+    enum Counter : std::size_t
+    {
+        CYCLES = 0u,
+        INSTRUCTIONS,
+        L1D_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        NUM_COUNTERS
+    };
+
+    using Sample = std::array<std::uint64_t, NUM_COUNTERS>;
+
+    PerfCounterGroup() = default;
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(PerfCounterGroup const&) = delete;
+    PerfCounterGroup& operator=(PerfCounterGroup const&) = delete;
+
+    // returns errno on failure, 0 on success
+    int open();
+    void close();
+
+    bool isOpen() const { return opened; }
+    bool isUserReadable() const { return userReadable; }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void read(Sample& sample) const
+    {
+        for (std::size_t i = 0u; i < NUM_COUNTERS; ++i)
+            sample[i] = readCounter(i);
+    }
+
+    static constexpr char const* COUNTER_NAMES[NUM_COUNTERS] = {
+        "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses"};
+
+private:
+    [[gnu::hot, gnu::always_inline]]
+    inline std::uint64_t readCounter(std::size_t i) const
+    {
+        auto const* page = pages[i];
+        if (!userReadable) [[unlikely]]
+            return readSlow(i);
+
+        // seqlock protocol from linux/perf_event.h
+        std::uint32_t seq;
+        std::uint64_t count;
+        do
+        {
+            seq = page->lock;
+            std::atomic_signal_fence(std::memory_order_acquire);
+
+            std::uint32_t const index = page->index;
+            count = page->offset;
+            if (index) [[likely]]
+            {
+                std::uint16_t const width = page->pmc_width;
+                std::int64_t pmc = static_cast<std::int64_t>(__rdpmc(static_cast<int>(index - 1u)));
+                pmc <<= 64u - width;
+                pmc >>= 64u - width;
+                count += pmc;
+            }
+
+            std::atomic_signal_fence(std::memory_order_acquire);
+        }
+        while (page->lock != seq);
+
+        return count;
+    }
+
+    std::uint64_t readSlow(std::size_t i) const;
+
+    std::array<int, NUM_COUNTERS> fds{-1, -1, -1, -1, -1};
+    std::array<perf_event_mmap_page*, NUM_COUNTERS> pages{};
+    bool opened = false;
+    bool userReadable = false;
+};
+
+} // namespace phoenix
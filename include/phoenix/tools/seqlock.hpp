@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace phoenix {
+
+// Single writer value that readers on other threads copy out without locking
+// The sequence is odd while a write is in progress, readers retry when it moved under them
+// Aligned to its own cache lines so neighbouring values written by other threads don't false share
+template<typename T>
+struct alignas(64) Seqlock
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    Seqlock() = default;
+
+    explicit Seqlock(T const& value)
+        : data{value}
+    {}
+
+    // writer
+    [[gnu::hot, gnu::always_inline]]
+    inline void store(T const& value)
+    {
+        std::uint64_t const current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&data, &value, sizeof(T));
+        sequence.store(current + 2u, std::memory_order_release);
+    }
+
+    // writer, changes the value in place for when only part of it moves
+    template<typename Writer>
+    [[gnu::hot, gnu::always_inline]]
+    inline void update(Writer&& writer)
+    {
+        std::uint64_t const current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        writer(data);
+        sequence.store(current + 2u, std::memory_order_release);
+    }
+
+    // writer, no synchronisation needed for the thread that stores
+    T const& get() const { return data; }
+
+    // any thread
+    [[gnu::hot, gnu::always_inline]]
+    inline T load() const
+    {
+        T out;
+        std::uint64_t before;
+        do
+        {
+            before = sequence.load(std::memory_order_acquire);
+            std::memcpy(&out, &data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        while ((before & 1u) || before != sequence.load(std::memory_order_relaxed));
+
+        return out;
+    }
+
+    // number of completed stores
+    std::uint64_t getVersion() const { return sequence.load(std::memory_order_acquire) / 2u; }
+
+private:
+    std::atomic<std::uint64_t> sequence{0u};
+    T data{};
+};
+
+} // namespace phoenix
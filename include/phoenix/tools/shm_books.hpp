@@ -0,0 +1,148 @@
+#pragma once
+
+#include "phoenix/tools/seqlock.hpp"
+#include "phoenix/tools/shm_region.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace phoenix {
+
+// Layout of the top levels of the books in POSIX shared memory, written by one trading process and read by any
+// number of others (dashboards, risk, research) without syscalls or locks
+// Prices and volumes are the raw fixed point values of the writer, divided by the multipliers in the header
+struct ShmLevel
+{
+    std::uint64_t price;
+    std::uint64_t volume;
+};
+
+struct ShmBook
+{
+    static constexpr std::size_t DEPTH = 10u;
+    static constexpr std::size_t SYMBOL_SIZE = 32u;
+
+    char symbol[SYMBOL_SIZE];
+    std::int64_t timestamp; // ns since epoch of the last update, coarse clock
+    std::uint32_t numBids;
+    std::uint32_t numAsks;
+    ShmLevel bids[DEPTH];
+    ShmLevel asks[DEPTH];
+};
+
+struct ShmBooks
+{
+    static constexpr std::uint64_t MAGIC = 0x4b4f4f42584e4850ull; // PHNXBOOK
+    static constexpr std::uint32_t VERSION = 1u;
+    static constexpr std::size_t MAX_BOOKS = 64u;
+
+    struct alignas(64) Header
+    {
+        std::uint64_t magic;
+        std::uint32_t version;
+        std::uint32_t depth;
+        std::uint64_t priceMultiplier;
+        std::uint64_t volumeMultiplier;
+        std::atomic<std::uint32_t> numBooks; // a book is fully registered before this covers it
+    };
+
+    Header header;
+    Seqlock<ShmBook> books[MAX_BOOKS];
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic<std::uint64_t>::is_always_lock_free);
+
+// Trading side, creates the region and publishes with a seqlock per book
+struct ShmBookWriter
+{
+    ShmBookWriter() = default;
+    ~ShmBookWriter();
+
+    ShmBookWriter(ShmBookWriter const&) = delete;
+    ShmBookWriter& operator=(ShmBookWriter const&) = delete;
+
+    // returns errno on failure, 0 on success
+    int open(std::string const& name, std::uint64_t priceMultiplier, std::uint64_t volumeMultiplier);
+    void close();
+
+    bool isOpen() const { return region; }
+
+    // index of the book for the symbol, books are never removed
+    std::uint32_t add(std::string_view symbol);
+
+    // Book is anything with getNumBids/getNumAsks and visitBids/visitAsks over (price, volume)
+    // Costs the trading thread two sequence stores and one store per published level
+    template<typename Book>
+    [[gnu::hot, gnu::always_inline]]
+    inline void publish(std::uint32_t index, Book const& book)
+    {
+        std::int64_t const timestamp = coarseNow();
+        region->books[index].update(
+            [&](ShmBook& out)
+            {
+                out.timestamp = timestamp;
+                out.numBids = copyLevels(out.bids, [&](auto&& visitor) { book.visitBids(ShmBook::DEPTH, visitor); });
+                out.numAsks = copyLevels(out.asks, [&](auto&& visitor) { book.visitAsks(ShmBook::DEPTH, visitor); });
+            });
+    }
+
+private:
+    template<typename Visit>
+    [[gnu::always_inline]]
+    static inline std::uint32_t copyLevels(ShmLevel* levels, Visit&& visit)
+    {
+        std::uint32_t count = 0u;
+        visit(
+            [&](auto const& price, auto const& volume)
+            {
+                levels[count].price = price.getValue();
+                levels[count].volume = volume.getValue();
+                ++count;
+            });
+
+        return count;
+    }
+
+    static std::int64_t coarseNow();
+
+    ShmRegion mapping;
+    ShmBooks* region = nullptr;
+};
+
+// Any other process, maps the region read only
+struct ShmBookReader
+{
+    ShmBookReader() = default;
+    ~ShmBookReader();
+
+    ShmBookReader(ShmBookReader const&) = delete;
+    ShmBookReader& operator=(ShmBookReader const&) = delete;
+
+    // returns errno on failure (EPROTO for a region of another layout), 0 on success
+    int open(std::string const& name);
+    void close();
+
+    bool isOpen() const { return region; }
+
+    std::size_t getNumBooks() const { return region->header.numBooks.load(std::memory_order_acquire); }
+    double getPriceMultiplier() const { return static_cast<double>(region->header.priceMultiplier); }
+    double getVolumeMultiplier() const { return static_cast<double>(region->header.volumeMultiplier); }
+
+    // changes on every publish of the book, cheap enough to poll
+    std::uint64_t getVersion(std::size_t index) const { return region->books[index].getVersion(); }
+
+    // consistent copy of one book
+    ShmBook read(std::size_t index) const { return region->books[index].load(); }
+
+    // index of the symbol, or getNumBooks() when it isn't published
+    std::size_t find(std::string_view symbol) const;
+
+private:
+    ShmRegion mapping;
+    ShmBooks const* region = nullptr;
+};
+
+} // namespace phoenix
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace phoenix {
+
+// A POSIX shared memory mapping, prefaulted
+// The side that creates a region owns its name and unlinks it on close, the other side only maps it
+struct ShmRegion
+{
+    ShmRegion() = default;
+    ~ShmRegion();
+
+    ShmRegion(ShmRegion const&) = delete;
+    ShmRegion& operator=(ShmRegion const&) = delete;
+
+    // a fresh zeroed read write region, replacing one left behind by a previous run, returns errno on failure, 0 on success
+    // permissions of the name, 0644 lets processes of other users map it read only
+    int create(std::string const& name, std::size_t size, unsigned permissions = 0600u);
+
+    // an existing region of at least size bytes, returns errno on failure (EPROTO when it's smaller), 0 on success
+    int open(std::string const& name, std::size_t size, bool isReadOnly = false);
+
+    void close();
+
+    bool isOpen() const { return memory; }
+    void* get() const { return memory; }
+
+private:
+    std::string name;
+    void* memory = nullptr;
+    std::size_t size = 0u;
+    bool isOwner = false;
+};
+
+} // namespace phoenix
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace phoenix {
+
+// Single-producer single-consumer ring of fixed size records between two processes, placed in shared memory as is
+// Indexes only ever grow, each side caches the index of the other and only loads it again when the ring looks full or empty
+// A span of records is published with one store, so the consumer sees all of them or none
+template<typename Record, std::size_t CAPACITY>
+struct ShmRing
+{
+    static_assert(std::has_single_bit(CAPACITY));
+    static_assert(std::is_trivially_copyable_v<Record>);
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+    static constexpr std::uint64_t MASK = CAPACITY - 1u;
+
+    // producer: false, and nothing written, without room for every record
+    [[gnu::hot, gnu::always_inline]]
+    inline bool tryPush(std::span<Record const> records)
+    {
+        std::uint64_t const position = producer.head.load(std::memory_order_relaxed);
+        if (position + records.size() - producer.cachedTail > CAPACITY)
+        {
+            producer.cachedTail = consumer.tail.load(std::memory_order_acquire);
+            if (position + records.size() - producer.cachedTail > CAPACITY) [[unlikely]]
+                return false;
+        }
+
+        for (std::size_t i = 0u; i < records.size(); ++i)
+            slots[(position + i) & MASK] = records[i];
+
+        producer.head.store(position + records.size(), std::memory_order_release);
+        return true;
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline bool tryPush(Record const& record) { return tryPush(std::span<Record const>{&record, 1u}); }
+
+    // producer: a record to fill in place, published by commit, nullptr when the ring is full
+    [[gnu::hot, gnu::always_inline]]
+    inline Record* reserve()
+    {
+        std::uint64_t const position = producer.head.load(std::memory_order_relaxed);
+        if (position - producer.cachedTail == CAPACITY)
+        {
+            producer.cachedTail = consumer.tail.load(std::memory_order_acquire);
+            if (position - producer.cachedTail == CAPACITY) [[unlikely]]
+                return nullptr;
+        }
+
+        return &slots[position & MASK];
+    }
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void commit()
+    {
+        producer.head.store(producer.head.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+    }
+
+    // producer: true once the consumer popped every record published
+    [[gnu::hot, gnu::always_inline]]
+    inline bool isDrained()
+    {
+        std::uint64_t const position = producer.head.load(std::memory_order_relaxed);
+        if (position != producer.cachedTail)
+            producer.cachedTail = consumer.tail.load(std::memory_order_acquire);
+
+        return position == producer.cachedTail;
+    }
+
+    // consumer: records published and not popped yet
+    [[gnu::hot, gnu::always_inline]]
+    inline std::size_t getAvailable()
+    {
+        std::uint64_t const position = consumer.tail.load(std::memory_order_relaxed);
+        if (position == consumer.cachedHead)
+            consumer.cachedHead = producer.head.load(std::memory_order_acquire);
+
+        return consumer.cachedHead - position;
+    }
+
+    // consumer: the nth record from the front, n < getAvailable()
+    [[gnu::hot, gnu::always_inline]]
+    inline Record const& peek(std::size_t n = 0u) const
+    {
+        return slots[(consumer.tail.load(std::memory_order_relaxed) + n) & MASK];
+    }
+
+    // consumer: releases n records from the front
+    [[gnu::hot, gnu::always_inline]]
+    inline void pop(std::size_t n = 1u)
+    {
+        consumer.tail.store(consumer.tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+    }
+
+private:
+    static constexpr std::size_t CACHE_LINE_SIZE = 64u;
+
+    // each side writes only its own line, and reads the other one when its cached index runs out
+    struct alignas(CACHE_LINE_SIZE)
+    {
+        std::atomic<std::uint64_t> head{0u};
+        std::uint64_t cachedTail = 0u;
+    } producer;
+
+    struct alignas(CACHE_LINE_SIZE)
+    {
+        std::atomic<std::uint64_t> tail{0u};
+        std::uint64_t cachedHead = 0u;
+    } consumer;
+
+    alignas(CACHE_LINE_SIZE) Record slots[CAPACITY];
+};
+
+} // namespace phoenix
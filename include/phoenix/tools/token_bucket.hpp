@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace phoenix {
+
+// Credits refilled continuously up to a cap, the shape of Deribit's rate limits where every request costs credits
+// The fraction of a credit left over by a refill is carried to the next one, so the rate is exact however often it's polled
+struct TokenBucket
+{
+    using Clock = std::chrono::steady_clock;
+
+    TokenBucket(std::uint64_t maxCredits, std::uint64_t creditsPerSecond)
+        : maxCredits{maxCredits}
+        , creditsPerSecond{creditsPerSecond}
+        , credits{maxCredits}
+    {}
+
+    // takes cost credits if there are that many, otherwise leaves the bucket as it is
+    [[gnu::hot, gnu::always_inline]]
+    inline bool tryTake(std::uint64_t cost, Clock::time_point now = Clock::now())
+    {
+        refill(now);
+        if (credits < cost)
+            return false;
+
+        credits -= cost;
+        return true;
+    }
+
+    std::uint64_t getCredits(Clock::time_point now = Clock::now())
+    {
+        refill(now);
+        return credits;
+    }
+
+    std::uint64_t getMaxCredits() const { return maxCredits; }
+
+private:
+    static constexpr std::uint64_t NS_PER_SECOND = 1'000'000'000u;
+
+    [[gnu::hot, gnu::always_inline]]
+    inline void refill(Clock::time_point now)
+    {
+        auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastRefill).count();
+        if (elapsed <= 0)
+            return;
+
+        lastRefill = now;
+        if (credits == maxCredits)
+            return;
+
+        // a long idle fills the bucket, and the product below stays in range
+        auto const ns = static_cast<std::uint64_t>(elapsed);
+        if (ns >= (maxCredits - credits) * NS_PER_SECOND / creditsPerSecond + 1u)
+        {
+            credits = maxCredits;
+            remainder = 0u;
+            return;
+        }
+
+        std::uint64_t const scaled = ns * creditsPerSecond + remainder;
+        credits = std::min(maxCredits, credits + scaled / NS_PER_SECOND);
+        remainder = credits == maxCredits ? 0u : scaled % NS_PER_SECOND;
+    }
+
+    std::uint64_t maxCredits;
+    std::uint64_t creditsPerSecond;
+    std::uint64_t credits;
+    std::uint64_t remainder = 0u; // credit-nanoseconds short of the next credit
+    Clock::time_point lastRefill = Clock::now();
+};
+
+} // namespace phoenix
@@ -0,0 +1,19 @@
+#pragma once
+
+// USDT static probes under the "phoenix" provider, for bpftrace/perf probe on a live process:
+//   bpftrace -e 'usdt:./phoenix_tri_btc:phoenix:order_send { printf("%s\n", str(arg0, arg1)); }'
+// Each probe is a single NOP until a tracer attaches, arguments must be integers or pointers
+// Every strategy passes the same arguments to a probe, so one script works on any of them:
+//   receive(data, size), parse(size), md_update(book id), md_batch(frames, backlog bytes), trigger(strategy's case),
+//   order_send(data, size), exec_report(data, size), throttle_reject(messages, credits left)
+// Compiled out without <sys/sdt.h> (systemtap-sdt-dev) or with PHOENIX_TRACEPOINTS=OFF
+#if __has_include(<sys/sdt.h>) && !defined(PHOENIX_NO_TRACEPOINTS)
+#include <sys/sdt.h>
+#define PHOENIX_TRACE(name, ...) STAP_PROBEV(phoenix, name __VA_OPT__(, ) __VA_ARGS__)
+#else
+#define PHOENIX_TRACE(name, ...) \
+    do \
+    { \
+    } \
+    while (false)
+#endif
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <pthread.h>
+
 namespace phoenix {
 
 void setMaxThreadPriority();
 
+// returns 0 on success, otherwise the error number
+int setThreadAffinity(pthread_t thread, int cpu);
+
 }
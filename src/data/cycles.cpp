@@ -0,0 +1,125 @@
+#include "phoenix/data/cycles.hpp"
+
+#include <algorithm>
+
+namespace phoenix {
+
+namespace {
+
+struct Edge
+{
+    std::uint32_t to;
+    std::uint32_t instrument;
+    bool isBuy;
+};
+
+using Graph = std::vector<std::vector<Edge>>;
+
+void findCycles(
+    Graph const& graph,
+    std::uint32_t start,
+    std::uint32_t current,
+    std::size_t maxLegs,
+    Cycle& path,
+    std::vector<bool>& visited,
+    std::vector<Cycle>& out,
+    std::vector<std::uint32_t>& outStarts)
+{
+    for (auto const& edge : graph[current])
+    {
+        std::uint32_t const numLegs = path.numLegs + 1u;
+        if (edge.to == start && numLegs >= 3u)
+        {
+            Cycle& cycle = out.emplace_back(path);
+            cycle.legs[path.numLegs] = {edge.instrument, edge.isBuy};
+            cycle.numLegs = numLegs;
+            outStarts.push_back(start);
+            continue;
+        }
+
+        // only currencies after the start, so every rotation of a cycle is found from its lowest currency once
+        if (edge.to <= start || visited[edge.to] || numLegs >= maxLegs)
+            continue;
+
+        visited[edge.to] = true;
+        path.legs[path.numLegs++] = {edge.instrument, edge.isBuy};
+        findCycles(graph, start, edge.to, maxLegs, path, visited, out, outStarts);
+        --path.numLegs;
+        visited[edge.to] = false;
+    }
+}
+
+} // namespace
+
+std::optional<std::pair<std::string_view, std::string_view>> CycleSet::splitSymbol(std::string_view symbol)
+{
+    auto const pos = symbol.find('_');
+    if (pos == std::string_view::npos || !pos || pos + 1u == symbol.size() ||
+        symbol.find('_', pos + 1u) != std::string_view::npos)
+        return std::nullopt;
+
+    return std::pair{symbol.substr(0u, pos), symbol.substr(pos + 1u)};
+}
+
+void CycleSet::build(std::vector<std::string> const& symbols, std::size_t maxLegs)
+{
+    maxLegs = std::min(maxLegs, Cycle::MAX_LEGS);
+    currencies.clear();
+    startCurrency.clear();
+    cycles.clear();
+
+    auto const intern = [&](std::string_view currency)
+    {
+        auto const it = std::find(currencies.begin(), currencies.end(), currency);
+        if (it != currencies.end())
+            return static_cast<std::uint32_t>(it - currencies.begin());
+
+        currencies.emplace_back(currency);
+        return static_cast<std::uint32_t>(currencies.size() - 1u);
+    };
+
+    Graph graph;
+    for (std::uint32_t i = 0u; i < symbols.size(); ++i)
+    {
+        auto const [base, quote] = *splitSymbol(symbols[i]);
+        std::uint32_t const from = intern(base);
+        std::uint32_t const to = intern(quote);
+        graph.resize(currencies.size());
+
+        // selling the base gets the quote, buying it spends the quote
+        graph[from].push_back({to, i, false});
+        graph[to].push_back({from, i, true});
+    }
+
+    Cycle path;
+    std::vector<bool> visited(currencies.size(), false);
+    for (std::uint32_t start = 0u; start < currencies.size(); ++start)
+        findCycles(graph, start, start, maxLegs, path, visited, cycles, startCurrency);
+
+    cyclesOf.assign(symbols.size(), {});
+    slotsOf.assign(symbols.size(), {});
+    for (auto& legWeights : weights)
+        legWeights.assign(cycles.size(), 0.0);
+
+    for (std::uint32_t c = 0u; c < cycles.size(); ++c)
+    {
+        auto const& cycle = cycles[c];
+        for (std::uint32_t leg = 0u; leg < cycle.numLegs; ++leg)
+        {
+            auto const& [instrument, isBuy] = cycle.legs[leg];
+            cyclesOf[instrument].push_back(c);
+            slotsOf[instrument].push_back({c, leg, isBuy});
+            weights[leg][c] = EMPTY;
+        }
+    }
+
+    std::size_t maxCyclesOf = 0u;
+    for (auto const& indices : cyclesOf)
+        maxCyclesOf = std::max(maxCyclesOf, indices.size());
+
+    edges.assign(maxCyclesOf, 0.0);
+}
+
+std::string_view CycleSet::getStartCurrency(std::size_t index) const { return currencies[startCurrency[index]]; }
+
+} // namespace phoenix
@@ -56,6 +56,32 @@ std::optional<std::string_view> FIXCircularBuffer::getMsg(std::size_t bytesRead)
     return result;
 }
 
+bool FIXCircularBuffer::hasMsg() const
+{
+    if (end - start < FIX_EXPECTED_MIN_LENGTH)
+        return false;
+
+    std::size_t i = start;
+    while (i < end && buffer[i] != '\x01')
+        ++i;
+
+    ++i;
+    if (i + 2u >= end || buffer[i] != '9' || buffer[i + 1u] != '=')
+        return false;
+
+    i += 2u;
+    char const* lenStart = &buffer[i];
+    while (i < end && buffer[i] != '\x01')
+        ++i;
+
+    if (i == end)
+        return false;
+
+    std::size_t length = 0u;
+    std::from_chars(lenStart, &buffer[i], length);
+    return i + 1u + length + FIX_CHECKSUM_LENGTH <= end;
+}
+
 void FIXCircularBuffer::advanceMoveOverflow(std::size_t newStart, std::size_t newEnd)
 {
     if (newEnd < BUFFER_CAPACITY - BUFFER_WRAP_BOUNDARY) [[likely]]
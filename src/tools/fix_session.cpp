@@ -0,0 +1,38 @@
+#include "phoenix/tools/fix_session.hpp"
+
+#include <cstdlib>
+
+#include <linux/socket.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+namespace phoenix {
+
+void FIXSession::connect(boost::asio::io_context& ioContext, std::string const& host, std::string const& portStr, bool isColo)
+{
+    namespace io = boost::asio;
+
+    if (isColo)
+    {
+        int port = std::atoi(portStr.c_str());
+        io::ip::tcp::endpoint endpoint(io::ip::address::from_string(host), port);
+        socket.connect(endpoint);
+    }
+    else
+    {
+        io::ip::tcp::resolver resolver{ioContext};
+        auto endpoints = resolver.resolve(host, portStr);
+        io::connect(socket, endpoints);
+    }
+
+    socket.set_option(io::ip::tcp::no_delay(true));
+    socket.set_option(io::socket_base::receive_buffer_size(8 * 1024));
+    socket.set_option(io::socket_base::send_buffer_size(8 * 1024));
+
+    auto const fd = socket.native_handle();
+    setsockopt(fd, SOL_SOCKET, SO_PRIORITY, &SOCKET_PRIORITY, sizeof(SOCKET_PRIORITY));
+    setsockopt(fd, IPPROTO_TCP, TCP_QUICKACK, &SOCKET_ENABLE_FLAG, sizeof(SOCKET_ENABLE_FLAG));
+    setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &SOCKET_POLL_MICROSECONDS, sizeof(SOCKET_POLL_MICROSECONDS));
+}
+
+} // namespace phoenix
@@ -0,0 +1,44 @@
+#include "phoenix/tools/latency_histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace phoenix {
+
+std::uint64_t LatencyHistogram::getQuantile(double q) const
+{
+    if (!count)
+        return 0u;
+
+    auto const rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count)));
+    std::uint64_t seen = 0u;
+    for (std::size_t i = 0u; i < NUM_BUCKETS; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank && buckets[i])
+            return i + 1u < NUM_BUCKETS ? std::min(getBucketLowerBound(i + 1u) - 1u, max) : max;
+    }
+
+    return max;
+}
+
+std::uint64_t LatencyHistogram::getBucketLowerBound(std::size_t bucket)
+{
+    if (bucket < SUB_BUCKETS)
+        return bucket;
+
+    std::size_t const msb = (bucket - SUB_BUCKETS) / SUB_BUCKETS + SUB_BITS;
+    std::size_t const sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (msb - SUB_BITS);
+}
+
+void LatencyHistogram::reset()
+{
+    buckets.fill(0u);
+    count = 0u;
+    numNegative = 0u;
+    sum = 0u;
+    max = 0u;
+}
+
+} // namespace phoenix
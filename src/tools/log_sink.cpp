@@ -0,0 +1,117 @@
+#include "phoenix/tools/log_sink.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace phoenix {
+
+void LogSink::FreeBuffer::operator()(char* buffer) const { std::free(buffer); }
+
+LogSink::LogSink(std::size_t capacity)
+    : capacity{capacity}
+    , buffer{static_cast<char*>(std::aligned_alloc(BUFFER_ALIGNMENT, capacity))}
+{
+    std::memset(buffer.get(), 0, capacity); // prefault
+    setp(buffer.get(), buffer.get() + capacity);
+}
+
+LogSink::~LogSink() { close(); }
+
+int LogSink::open(char const* path)
+{
+    close();
+
+    fd = ::open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return errno;
+
+    ownsFd = true;
+    return 0;
+}
+
+void LogSink::attach(int newFd)
+{
+    close();
+    fd = newFd;
+    ownsFd = false;
+}
+
+void LogSink::flush()
+{
+    char const* data = pbase();
+    std::size_t remaining = pptr() - pbase();
+
+    while (remaining && fd >= 0)
+    {
+        ssize_t const written = ::write(fd, data, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            break; // nowhere to report this, the entries are dropped
+        }
+
+        data += written;
+        remaining -= written;
+    }
+
+    setp(buffer.get(), buffer.get() + capacity);
+}
+
+void LogSink::close()
+{
+    flush();
+
+    if (ownsFd && fd >= 0)
+        ::close(fd);
+
+    fd = -1;
+    ownsFd = false;
+}
+
+LogSink::int_type LogSink::overflow(int_type c)
+{
+    flush();
+
+    if (!traits_type::eq_int_type(c, traits_type::eof()))
+        sputc(traits_type::to_char_type(c));
+
+    return traits_type::not_eof(c);
+}
+
+int LogSink::sync()
+{
+    flush();
+    return 0;
+}
+
+void LogSink::formatSecond(std::int64_t seconds)
+{
+    std::time_t const timeT = seconds;
+    std::tm tm;
+    gmtime_r(&timeT, &tm);
+
+    // room for any int in every field, only the first SECOND_PREFIX_LENGTH bytes are kept
+    char prefix[6u * 11u + 7u];
+    std::snprintf(
+        prefix,
+        sizeof(prefix),
+        "%04d-%02d-%02dT%02d:%02d:%02d.",
+        tm.tm_year + 1900,
+        tm.tm_mon + 1,
+        tm.tm_mday,
+        tm.tm_hour,
+        tm.tm_min,
+        tm.tm_sec);
+
+    std::memcpy(secondPrefix, prefix, SECOND_PREFIX_LENGTH);
+    cachedSecond = seconds;
+}
+
+} // namespace phoenix
@@ -0,0 +1,69 @@
+#include "phoenix/tools/node_arena.hpp"
+
+#include <algorithm>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace phoenix {
+
+NodeArena::NodeArena(bool hugePages, std::size_t chunkNodes)
+    : chunkNodes{chunkNodes}
+    , hugePages{hugePages}
+{
+    assert(chunkNodes && "Chunks must hold at least one node");
+}
+
+NodeArena::~NodeArena()
+{
+    for (auto const& chunk : chunks)
+        ::munmap(chunk.memory, chunk.bytes);
+}
+
+void NodeArena::grow(std::size_t size)
+{
+    if (!nodeSize)
+    {
+        nodeSize = std::max(size, sizeof(FreeNode));
+        nodeSize = (nodeSize + NODE_ALIGNMENT - 1u) & ~(NODE_ALIGNMENT - 1u);
+    }
+
+    std::size_t bytes = nodeSize * chunkNodes;
+    void* memory = MAP_FAILED;
+
+    // MAP_POPULATE so that the hot path never takes a page fault on a fresh node
+    if (hugePages)
+    {
+        std::size_t const hugeBytes = (bytes + HUGE_PAGE_SIZE - 1u) & ~(HUGE_PAGE_SIZE - 1u);
+        memory = ::mmap(
+            nullptr, hugeBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+
+        if (memory != MAP_FAILED)
+        {
+            bytes = hugeBytes;
+            hugePagesUsed = true;
+        }
+    }
+
+    if (memory == MAP_FAILED)
+        memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+
+    if (memory == MAP_FAILED)
+        throw std::bad_alloc{};
+
+    chunks.push_back({memory, bytes});
+
+    // threaded back to front so nodes are handed out in address order
+    std::size_t const numNodes = bytes / nodeSize;
+    auto* base = static_cast<std::byte*>(memory);
+    for (std::size_t i = numNodes; i > 0u; --i)
+    {
+        auto* node = reinterpret_cast<FreeNode*>(base + (i - 1u) * nodeSize);
+        node->next = freeList;
+        freeList = node;
+    }
+
+    capacity += numNodes;
+}
+
+} // namespace phoenix
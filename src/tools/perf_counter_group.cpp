@@ -0,0 +1,100 @@
+#include "phoenix/tools/perf_counter_group.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+namespace phoenix {
+
+namespace {
+perf_event_attr makeAttr(std::uint32_t type, std::uint64_t config)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return attr;
+}
+
+constexpr std::uint64_t cacheConfig(std::uint64_t cache, std::uint64_t op, std::uint64_t result)
+{
+    return cache | (op << 8u) | (result << 16u);
+}
+} // namespace
+
+PerfCounterGroup::~PerfCounterGroup() { close(); }
+
+int PerfCounterGroup::open()
+{
+    // clang-format off
+    perf_event_attr const attrs[NUM_COUNTERS] = {
+        makeAttr(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES),
+        makeAttr(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS),
+        makeAttr(PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)),
+        makeAttr(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES),
+        makeAttr(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES),
+    };
+    // clang-format on
+
+    userReadable = true;
+    for (std::size_t i = 0u; i < NUM_COUNTERS; ++i)
+    {
+        // calling thread only, any cpu, first counter leads the group so all are scheduled together
+        int const groupFd = i == 0u ? -1 : fds[0];
+        fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attrs[i], 0, -1, groupFd, 0));
+        if (fds[i] < 0)
+        {
+            int const error = errno;
+            close();
+            return error;
+        }
+
+        void* page = mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED, fds[i], 0);
+        if (page == MAP_FAILED)
+        {
+            int const error = errno;
+            close();
+            return error;
+        }
+
+        pages[i] = static_cast<perf_event_mmap_page*>(page);
+        userReadable = userReadable && pages[i]->cap_user_rdpmc;
+    }
+
+    opened = true;
+    return 0;
+}
+
+void PerfCounterGroup::close()
+{
+    for (std::size_t i = 0u; i < NUM_COUNTERS; ++i)
+    {
+        if (pages[i])
+            munmap(pages[i], sysconf(_SC_PAGESIZE));
+
+        if (fds[i] >= 0)
+            ::close(fds[i]);
+
+        pages[i] = nullptr;
+        fds[i] = -1;
+    }
+
+    opened = false;
+    userReadable = false;
+}
+
+std::uint64_t PerfCounterGroup::readSlow(std::size_t i) const
+{
+    std::uint64_t count = 0u;
+    if (::read(fds[i], &count, sizeof(count)) != sizeof(count))
+        return 0u;
+
+    return count;
+}
+
+} // namespace phoenix
@@ -0,0 +1,102 @@
+#include "phoenix/tools/shm_books.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <time.h>
+
+namespace phoenix {
+
+ShmBookWriter::~ShmBookWriter() { close(); }
+
+int ShmBookWriter::open(std::string const& name, std::uint64_t priceMultiplier, std::uint64_t volumeMultiplier)
+{
+    close();
+
+    // a fresh region every run so readers never see books of a previous layout
+    if (int const error = mapping.create(name, sizeof(ShmBooks), 0644u))
+        return error;
+
+    region = new (mapping.get()) ShmBooks{};
+    region->header.depth = ShmBook::DEPTH;
+    region->header.priceMultiplier = priceMultiplier;
+    region->header.volumeMultiplier = volumeMultiplier;
+    region->header.version = ShmBooks::VERSION;
+
+    // readers check the magic last
+    std::atomic_thread_fence(std::memory_order_release);
+    region->header.magic = ShmBooks::MAGIC;
+    return 0;
+}
+
+void ShmBookWriter::close()
+{
+    mapping.close();
+    region = nullptr;
+}
+
+std::uint32_t ShmBookWriter::add(std::string_view symbol)
+{
+    std::uint32_t const index = region->header.numBooks.load(std::memory_order_relaxed);
+    if (index == ShmBooks::MAX_BOOKS)
+        return index;
+
+    region->books[index].update(
+        [&](ShmBook& book)
+        {
+            std::size_t const length = std::min(symbol.size(), ShmBook::SYMBOL_SIZE - 1u);
+            std::memcpy(book.symbol, symbol.data(), length);
+            book.symbol[length] = '\0';
+        });
+
+    region->header.numBooks.store(index + 1u, std::memory_order_release);
+    return index;
+}
+
+std::int64_t ShmBookWriter::coarseNow()
+{
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    return ts.tv_sec * 1'000'000'000 + ts.tv_nsec;
+}
+
+ShmBookReader::~ShmBookReader() { close(); }
+
+int ShmBookReader::open(std::string const& name)
+{
+    close();
+
+    if (int const error = mapping.open(name, sizeof(ShmBooks), true))
+        return error;
+
+    auto const* books = static_cast<ShmBooks const*>(mapping.get());
+    if (books->header.magic != ShmBooks::MAGIC || books->header.version != ShmBooks::VERSION)
+    {
+        mapping.close();
+        return EPROTO;
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    region = books;
+    return 0;
+}
+
+void ShmBookReader::close()
+{
+    mapping.close();
+    region = nullptr;
+}
+
+std::size_t ShmBookReader::find(std::string_view symbol) const
+{
+    std::size_t const numBooks = getNumBooks();
+    for (std::size_t i = 0u; i < numBooks; ++i)
+        if (symbol == read(i).symbol)
+            return i;
+
+    return numBooks;
+}
+
+} // namespace phoenix
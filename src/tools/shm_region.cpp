@@ -0,0 +1,91 @@
+#include "phoenix/tools/shm_region.hpp"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace phoenix {
+
+ShmRegion::~ShmRegion() { close(); }
+
+int ShmRegion::create(std::string const& newName, std::size_t newSize, unsigned permissions)
+{
+    close();
+
+    ::shm_unlink(newName.c_str());
+    int const fd = ::shm_open(newName.c_str(), O_CREAT | O_EXCL | O_RDWR, static_cast<mode_t>(permissions));
+    if (fd < 0)
+        return errno;
+
+    // ftruncate zeroes the pages
+    if (::ftruncate(fd, static_cast<off_t>(newSize)) != 0)
+    {
+        int const error = errno;
+        ::close(fd);
+        ::shm_unlink(newName.c_str());
+        return error;
+    }
+
+    void* mapped = ::mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    int const error = errno;
+    ::close(fd);
+
+    if (mapped == MAP_FAILED)
+    {
+        ::shm_unlink(newName.c_str());
+        return error;
+    }
+
+    name = newName;
+    memory = mapped;
+    size = newSize;
+    isOwner = true;
+    return 0;
+}
+
+int ShmRegion::open(std::string const& newName, std::size_t newSize, bool isReadOnly)
+{
+    close();
+
+    int const fd = ::shm_open(newName.c_str(), isReadOnly ? O_RDONLY : O_RDWR, 0);
+    if (fd < 0)
+        return errno;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < newSize)
+    {
+        ::close(fd);
+        return EPROTO;
+    }
+
+    int const protection = isReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    void* mapped = ::mmap(nullptr, newSize, protection, MAP_SHARED | MAP_POPULATE, fd, 0);
+    int const error = errno;
+    ::close(fd);
+
+    if (mapped == MAP_FAILED)
+        return error;
+
+    name = newName;
+    memory = mapped;
+    size = newSize;
+    isOwner = false;
+    return 0;
+}
+
+void ShmRegion::close()
+{
+    if (!memory)
+        return;
+
+    ::munmap(memory, size);
+    if (isOwner)
+        ::shm_unlink(name.c_str());
+
+    memory = nullptr;
+}
+
+} // namespace phoenix
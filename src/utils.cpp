@@ -21,4 +21,12 @@ void setMaxThreadPriority()
     assert(result == 0 && "Cannot set CPU scheduling");
 }
 
+int setThreadAffinity(pthread_t thread, int cpu)
+{
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    return pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+}
+
 }